@@ -0,0 +1,55 @@
+/*
+  Copyright (c) 2022-23 Joshua Brakensiek, Neng Huang, Aaron Potechin and Uri Zwick
+
+  This code is licensed under the MIT License.
+*/
+
+#include <cstdio>
+#include "bivariate_normal.hpp"
+#include "biv_model.hpp"
+#include "args.hpp"
+#define NUM_THREADS 1
+
+// fits a certified model of biv_norm_cdf for use with --biv-model=PATH
+//   --box=T1LO,T1HI,T2LO,T2HI,RHOLO,RHOHI   the box (required)
+//   --degree=N   Chebyshev degree in each variable (default 6)
+//   --cells=K    sub-boxes per side for the remainder bound (default 8)
+//   --out=PATH   where to write the model (default biv_model.txt)
+// the model is used at most at the --prec it was fitted at
+int main(int argc, char* argv[]) {
+    parse_common_args(argc, argv);
+    flint_set_num_threads(NUM_THREADS);
+
+    double b[6];
+    const char* box = arg_str(argc, argv, "box");
+    if (box == NULL ||
+        sscanf(box, "%lf,%lf,%lf,%lf,%lf,%lf", b, b + 1, b + 2, b + 3, b + 4, b + 5) != 6) {
+        flint_printf("usage: %s --box=T1LO,T1HI,T2LO,T2HI,RHOLO,RHOHI "
+                     "[--degree=N] [--cells=K] [--out=PATH]\n", argv[0]);
+        return 1;
+    }
+    slong degree = arg_slong(argc, argv, "degree", 6);
+    slong cells = arg_slong(argc, argv, "cells", 8);
+    const char* out = arg_str(argc, argv, "out");
+    if (out == NULL) {
+        out = "biv_model.txt";
+    }
+
+    Arb lo[3] = {b[0], b[2], b[4]};
+    Arb hi[3] = {b[1], b[3], b[5]};
+    // a --biv-model already loaded must not feed its own refit
+    biv_model_set_enabled(0);
+    BivNormModel model = BivNormModel::fit(lo, hi, degree, cells);
+
+    flint_printf("REMAINDER: ");
+    model.rem.println();
+    if (!model.save(out)) {
+        flint_printf("cannot write %s\n", out);
+        return 1;
+    }
+    flint_printf("WROTE %s\n", out);
+
+    flint_cleanup_master();
+
+    return 0;
+}
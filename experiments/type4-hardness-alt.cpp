@@ -7,11 +7,17 @@
 #include <cstdio>
 #include <cassert>
 #include "max2sat.hpp"
+#include "args.hpp"
+#include "verify.hpp"
+#include "biv_cache.hpp"
+#include "biv_store.hpp"
+#include "biv_model.hpp"
 #include "constants.hpp"
 #define NUM_THREADS 1
 
-Arb prob (const Arb &t1, const Arb &t2, const Arb &b) {
-    Arb rho = - (1 - b) / (1 + b);
+// the hard distribution at b: rho and the weights q1..q6 of the six clauses
+void hard_weights(const Arb &b, Arb &rho, Arb q[6]) {
+    rho = - (1 - b) / (1 + b);
     Arb t = (1-b) / 2;
     Arb r12 = 1 - Arb::norm_cdf(Arb::safe_sqrt((1 - rho) / (1 + rho)) * Arb::norm_cdf_inv(t));
     Arb s1 = r12 * (1 - biv_norm_cdf_norm_thresh(t, t, rho)) +
@@ -25,26 +31,24 @@ Arb prob (const Arb &t1, const Arb &t2, const Arb &b) {
     flint_printf("p2: "); p2.println();
     flint_printf("p3: "); p3.println(); */
 
-    Arb q1 = p3 / 2;
-    Arb q2 = q1;
-    Arb q3 = p2 - p3/2;
-    Arb q4 = p1 - p3/2;
-    Arb q5 = q1;
-    Arb q6 = q1;
-
-    /*flint_printf("q1: "); q1.println();
-    flint_printf("q2: "); q2.println();
-    flint_printf("q3: "); q3.println();
-    flint_printf("q4: "); q4.println();
-    flint_printf("q5: "); q5.println();
-    flint_printf("q6: "); q6.println();*/
-
-    Arb ans_1 = q1 * (1 - biv_norm_cdf_norm_thresh(t1, t1, rho));
-    Arb ans_2 = q2 * (1 - biv_norm_cdf_norm_thresh(t2, t2, rho));
-    Arb ans_3 = q3 * (1 - biv_norm_cdf_norm_thresh(1-t1, t2, rho));
-    Arb ans_4 = q4 * (1 - biv_norm_cdf_norm_thresh(1-t2, t1, rho));
-    Arb ans_5 = q5 * t2;
-    Arb ans_6 = q6 * t1;
+    q[0] = p3 / 2;
+    q[1] = q[0];
+    q[2] = p2 - p3/2;
+    q[3] = p1 - p3/2;
+    q[4] = q[0];
+    q[5] = q[0];
+}
+
+Arb prob (const Arb &t1, const Arb &t2, const Arb &b) {
+    Arb rho, q[6];
+    hard_weights(b, rho, q);
+
+    Arb ans_1 = q[0] * (1 - biv_norm_cdf_norm_thresh(t1, t1, rho));
+    Arb ans_2 = q[1] * (1 - biv_norm_cdf_norm_thresh(t2, t2, rho));
+    Arb ans_3 = q[2] * (1 - biv_norm_cdf_norm_thresh(1-t1, t2, rho));
+    Arb ans_4 = q[3] * (1 - biv_norm_cdf_norm_thresh(1-t2, t1, rho));
+    Arb ans_5 = q[4] * t2;
+    Arb ans_6 = q[5] * t1;
     
     Arb num = ans_1 + ans_2 + ans_3 + ans_4 + ans_5 + ans_6;
     assert(! (num < -1e-9));
@@ -52,24 +56,11 @@ Arb prob (const Arb &t1, const Arb &t2, const Arb &b) {
     return num;
 }
 
-Arb prob_d_t1(const Arb &t1, const Arb &t2, const Arb &b) {
-    Arb rho = - (1 - b) / (1 + b);
-    Arb t = (1-b) / 2;
-    Arb r12 = 1 - Arb::norm_cdf(Arb::safe_sqrt((1 - rho) / (1 + rho)) * Arb::norm_cdf_inv(t));
-    Arb s1 = r12 * (1 - biv_norm_cdf_norm_thresh(t, t, rho)) +
-        (1 - r12) * (1 - biv_norm_cdf_norm_thresh(1-t, 1-t, rho));
-    Arb s2 = 1;
-    Arb diff = s2 - s1;
-    Arb p3 = (diff * 2) / (1 + diff * 2);
-    Arb p1 = r12 * (1 - p3);
-    Arb p2 = 1 - p1 - p3;
+// derivatives are in the coordinates norm_cdf_inv(t1), norm_cdf_inv(t2)
 
-    Arb q1 = p3 / 2;
-    Arb q2 = q1;
-    Arb q3 = p2 - p3/2;
-    Arb q4 = p1 - p3/2;
-    Arb q5 = q1;
-    Arb q6 = q1;
+Arb prob_d_t1(const Arb &t1, const Arb &t2, const Arb &b) {
+    Arb rho, q[6];
+    hard_weights(b, rho, q);
 
     Arb t1i = Arb::norm_cdf_inv(t1);
     Arb t2i = Arb::norm_cdf_inv(t2);
@@ -84,27 +75,12 @@ Arb prob_d_t1(const Arb &t1, const Arb &t2, const Arb &b) {
     Arb coef_5 = 0;
     Arb coef_6 = 1;
 
-    return y * (coef_1 * q1 + coef_2 * q2 + coef_3 * q3 + coef_4 * q4 + coef_5 * q5 + coef_6 * q6);
+    return y * (coef_1 * q[0] + coef_2 * q[1] + coef_3 * q[2] + coef_4 * q[3] + coef_5 * q[4] + coef_6 * q[5]);
 }
 
 Arb prob_d_t2(const Arb &t1, const Arb &t2, const Arb &b) {
-        Arb rho = - (1 - b) / (1 + b);
-    Arb t = (1-b) / 2;
-    Arb r12 = 1 - Arb::norm_cdf(Arb::safe_sqrt((1 - rho) / (1 + rho)) * Arb::norm_cdf_inv(t));
-    Arb s1 = r12 * (1 - biv_norm_cdf_norm_thresh(t, t, rho)) +
-        (1 - r12) * (1 - biv_norm_cdf_norm_thresh(1-t, 1-t, rho));
-    Arb s2 = 1;
-    Arb diff = s2 - s1;
-    Arb p3 = (diff * 2) / (1 + diff * 2);
-    Arb p1 = r12 * (1 - p3);
-    Arb p2 = 1 - p1 - p3;
-
-    Arb q1 = p3 / 2;
-    Arb q2 = q1;
-    Arb q3 = p2 - p3/2;
-    Arb q4 = p1 - p3/2;
-    Arb q5 = q1;
-    Arb q6 = q1;
+    Arb rho, q[6];
+    hard_weights(b, rho, q);
 
     Arb t1i = Arb::norm_cdf_inv(t1);
     Arb t2i = Arb::norm_cdf_inv(t2);
@@ -119,150 +95,56 @@ Arb prob_d_t2(const Arb &t1, const Arb &t2, const Arb &b) {
     Arb coef_5 = 1;
     Arb coef_6 = 0;
 
-    return y * (coef_1 * q1 + coef_2 * q2 + coef_3 * q3 + coef_4 * q4 + coef_5 * q5 + coef_6 * q6);
-}
-
-Arb prob_d_t1_d_t1(const Arb &t1, const Arb &t2, const Arb &b) {
-    Arb rho = - (1 - b) / (1 + b);
-    Arb t = (1-b) / 2;
-    Arb r12 = 1 - Arb::norm_cdf(Arb::safe_sqrt((1 - rho) / (1 + rho)) * Arb::norm_cdf_inv(t));
-    Arb s1 = r12 * (1 - biv_norm_cdf_norm_thresh(t, t, rho)) +
-        (1 - r12) * (1 - biv_norm_cdf_norm_thresh(1-t, 1-t, rho));
-    Arb s2 = 1;
-    Arb diff = s2 - s1;
-    Arb p3 = (diff * 2) / (1 + diff * 2);
-    Arb p1 = r12 * (1 - p3);
-    Arb p2 = 1 - p1 - p3;
-
-    Arb q1 = p3 / 2;
-    Arb q2 = q1;
-    Arb q3 = p2 - p3/2;
-    Arb q4 = p1 - p3/2;
-    Arb q5 = q1;
-    Arb q6 = q1;
-
-    Arb t1i = Arb::norm_cdf_inv(t1);
-    Arb t2i = Arb::norm_cdf_inv(t2);
-
-    Arb pdf_t1i = Arb::norm_pdf(t1i);
-    Arb x = -t1i * pdf_t1i;
-    Arb y = pdf_t1i;
-
-    Arb z = Arb::safe_sqrt((1 - rho) / (1 + rho)) * t1i;
-    Arb zz = (t2i + rho * t1i) / Arb::safe_sqrt(1 - rho.sqr());
-
-    Arb coef_1a = -2 * x * Arb::norm_cdf(z);
-    Arb coef_1b = -2 * y * Arb::safe_sqrt((1 - rho) / (1 + rho)) * Arb::norm_pdf(z);
-    Arb coef_2 = 0;
-    Arb coef_3 = x * Arb::norm_cdf(zz);
-    Arb coef_4 = -x * Arb::norm_cdf(-zz);
-    Arb coef_34 = y * rho / Arb::safe_sqrt(1 - rho.sqr()) * Arb::norm_pdf(zz);
-    Arb coef_5 = 0;
-    Arb coef_6 = x;
-
-    return (coef_1a + coef_1b) * q1 + coef_2 * q2 + (coef_3 + coef_34) * q3
-        + (coef_4 + coef_34)* q4 + coef_5 * q5 + coef_6 * q6;
-}
-
-Arb prob_d_t2_d_t2(const Arb &t1, const Arb &t2, const Arb &b) {
-    Arb rho = - (1 - b) / (1 + b);
-    Arb t = (1-b) / 2;
-    Arb r12 = 1 - Arb::norm_cdf(Arb::safe_sqrt((1 - rho) / (1 + rho)) * Arb::norm_cdf_inv(t));
-    Arb s1 = r12 * (1 - biv_norm_cdf_norm_thresh(t, t, rho)) +
-        (1 - r12) * (1 - biv_norm_cdf_norm_thresh(1-t, 1-t, rho));
-    Arb s2 = 1;
-    Arb diff = s2 - s1;
-    Arb p3 = (diff * 2) / (1 + diff * 2);
-    Arb p1 = r12 * (1 - p3);
-    Arb p2 = 1 - p1 - p3;
-
-    Arb q1 = p3 / 2;
-    Arb q2 = q1;
-    Arb q3 = p2 - p3/2;
-    Arb q4 = p1 - p3/2;
-    Arb q5 = q1;
-    Arb q6 = q1;
-
-    Arb t1i = Arb::norm_cdf_inv(t1);
-    Arb t2i = Arb::norm_cdf_inv(t2);
-
-    Arb pdf_t2i = Arb::norm_pdf(t2i);
-    Arb x = -t2i * pdf_t2i;
-    Arb y = pdf_t2i;
-
-    Arb z = Arb::safe_sqrt((1 - rho) / (1 + rho)) * t2i;
-    Arb zz = (t1i + rho * t2i) / Arb::safe_sqrt(1 - rho.sqr());
-
-    Arb coef_1 = 0;
-    Arb coef_2a = -2 * x * Arb::norm_cdf(z);
-    Arb coef_2b = -2 * y * Arb::safe_sqrt((1 - rho) / (1 + rho)) * Arb::norm_pdf(z);
-    Arb coef_3 = -x * Arb::norm_cdf(-zz);
-    Arb coef_4 = x * Arb::norm_cdf(zz);
-    Arb coef_34 = y * rho / Arb::safe_sqrt(1 - rho.sqr()) * Arb::norm_pdf(zz);
-    Arb coef_5 = x;
-    Arb coef_6 = 0;
-
-    return coef_1 * q1 + (coef_2a + coef_2b) * q2 + (coef_3 + coef_34) * q3
-        + (coef_4 + coef_34)* q4 + coef_5 * q5 + coef_6 * q6;
+    return y * (coef_1 * q[0] + coef_2 * q[1] + coef_3 * q[2] + coef_4 * q[3] + coef_5 * q[4] + coef_6 * q[5]);
 }
 
-
-Arb prob_d_t1_d_t2(const Arb &t1, const Arb &t2, const Arb &b) {
-    Arb rho = - (1 - b) / (1 + b);
-    Arb t = (1-b) / 2;
-    Arb r12 = 1 - Arb::norm_cdf(Arb::safe_sqrt((1 - rho) / (1 + rho)) * Arb::norm_cdf_inv(t));
-    Arb s1 = r12 * (1 - biv_norm_cdf_norm_thresh(t, t, rho)) +
-        (1 - r12) * (1 - biv_norm_cdf_norm_thresh(1-t, 1-t, rho));
-    Arb s2 = 1;
-    Arb diff = s2 - s1;
-    Arb p3 = (diff * 2) / (1 + diff * 2);
-    Arb p1 = r12 * (1 - p3);
-    Arb p2 = 1 - p1 - p3;
-
-    Arb q1 = p3 / 2;
-    Arb q2 = q1;
-    Arb q3 = p2 - p3/2;
-    Arb q4 = p1 - p3/2;
-    Arb q5 = q1;
-    Arb q6 = q1;
+// second partials d11, d22, d12, from one evaluation of the weights:
+// clauses 1-4 are 1 - Phi2 at (x1, x1), (x2, x2), (-x1, x2), (-x2, x1)
+// with x_i = norm_cdf_inv(t_i), and clauses 5, 6 are norm_cdf(x2), norm_cdf(x1)
+void prob_hessian(const Arb &t1, const Arb &t2, const Arb &b, Arb &d11, Arb &d22, Arb &d12) {
+    Arb rho, q[6];
+    hard_weights(b, rho, q);
 
     Arb t1i = Arb::norm_cdf_inv(t1);
     Arb t2i = Arb::norm_cdf_inv(t2);
 
-    Arb pdf_t1i = Arb::norm_pdf(t1i);
-    Arb x = -t1i * pdf_t1i;
-    Arb y = pdf_t1i;
-    Arb zz = (t2i + rho * t1i) / Arb::safe_sqrt(1 - rho.sqr());
+    Hessian3 h1 = biv_norm_cdf_hessian(t1i, t1i, rho);
+    Hessian3 h2 = biv_norm_cdf_hessian(t2i, t2i, rho);
+    Hessian3 h3 = biv_norm_cdf_hessian(-t1i, t2i, rho);
+    Hessian3 h4 = biv_norm_cdf_hessian(-t2i, t1i, rho);
 
-    return ((q3 + q4) / Arb::safe_sqrt(1-rho.sqr())) * y * Arb::norm_pdf(zz);
+    d11 = -q[0] * (h1.xx + 2 * h1.xy + h1.yy) - q[2] * h3.xx - q[3] * h4.yy
+        - q[5] * t1i * Arb::norm_pdf(t1i);
+    d22 = -q[1] * (h2.xx + 2 * h2.xy + h2.yy) - q[2] * h3.yy - q[3] * h4.xx
+        - q[4] * t2i * Arb::norm_pdf(t2i);
+    d12 = q[2] * h3.xy + q[3] * h4.xy;
 }
 
-int check(const Arb &t1, const Arb &t2, const Arb &b) {
+BoxVerdict decide(const Arb &t1, const Arb &t2, const Arb &b) {
     if (Arb::abs(t1 - (1-b)/2) < TYPE_4_HARD_EPS_ALT &&
         Arb::abs(t2 - (1+b)/2) < TYPE_4_HARD_EPS_ALT) {
-        Arb d11 = prob_d_t1_d_t1(t1, t2, b);
-        Arb d22 = prob_d_t2_d_t2(t1, t2, b);
-        Arb d12 = prob_d_t1_d_t2(t1, t2, b);
+        Arb d11, d22, d12;
+        prob_hessian(t1, t2, b, d11, d22, d12);
 
         d11.println();
         (d11 * d22 - d12 * d12).println();
         
         assert(!d11.is_nan() && !d22.is_nan() && !d12.is_nan());
         if (d11 < 0 && (d11 * d22 - d12 * d12) > 0) {
-            return 1;
+            return BOX_PROVEN;
         }
     }
 
     if (t1 < TYPE_4_HARD_EPS_ALT2 && t2 < TYPE_4_HARD_EPS_ALT2) {
-        return 1;
+        return BOX_PROVEN;
     }
 
     if (1-t1 < TYPE_4_HARD_EPS_ALT2 && 1-t2 < TYPE_4_HARD_EPS_ALT2) {
-        return 1;
+        return BOX_PROVEN;
     }
 
     if (prob(t1, t2, b) < prob((1-b)/2, (1+b)/2, b)) {
-        return 1;
+        return BOX_PROVEN;
     }
     
     if (t1 > 0 && t1 < 1 && t2 > 0 && t2 < 1) {
@@ -271,50 +153,27 @@ int check(const Arb &t1, const Arb &t2, const Arb &b) {
         Arb d_t2 = prob_d_t2(t1, t2, b);
 
         if (!d_t1.is_nan() && (d_t1 > 0 || d_t1 < 0)) {
-            return 1;
+            return BOX_PROVEN;
         }
         else if (!d_t2.is_nan() && (d_t2 > 0 || d_t2 < 0)) {
-            return 1;
+            return BOX_PROVEN;
         }
     }
 
-    // otherwise we need to split
-    Arb rt1 = t1.rad();
-    Arb rt2 = t2.rad();
-    Arb rb = b.rad();
-
-    /*flint_printf("AT: \n");
-    t1.println();
-    t2.println();
-    b.println();
-    prob(t1, t2, b).println();
-    prob_d_t1(t1, t2, b).println();
-    prob_d_t2(t1, t2, b).println();*/
-    
-
-    if (rt1 >= rt2 && rt1 >= rb) {
-#ifdef DEBUG
-        flint_printf("SPLIT: t1\n");
-#endif
-        return check(t1.left_half(), t2, b) && check(t1.right_half(), t2, b);
-    }
-    else if (rt2 >= rb) {
-#ifdef DEBUG
-        flint_printf("SPLIT: t2\n");
-#endif
-        return check(t1, t2.left_half(), b) &&
-                        check(t1, t2.right_half(), b);
-    }
-    else {
-        return check(t1, t2, b.left_half()) &&
-                        check(t1, t2, b.right_half());
+    return BOX_UNDECIDED;
+}
 
-    }
+// written to the report if the search fails at x
+void describe(FILE* out, const Box &x) {
+    verify_fprint(out, "prob", prob(x[0], x[1], x[2]));
+    verify_fprint(out, "d_t1", prob_d_t1(x[0], x[1], x[2]));
+    verify_fprint(out, "d_t2", prob_d_t2(x[0], x[1], x[2]));
 }
 
 int main(int argc, char* argv[]) {
     
     flint_set_num_threads(NUM_THREADS);
+    parse_common_args(argc, argv);
     
     //(1/(1-eval_low(0.1489, 0.1489))).println();
     //(1/(1-eval_low(-0.1489, -0.1489))).println();
@@ -385,13 +244,25 @@ int main(int argc, char* argv[]) {
     prob(t1, t2, TYPE_4_B1_HARD).println();
     prob_d_t1(t1, t2, TYPE_4_B1_HARD).println();
     prob_d_t2(t1, t2, TYPE_4_B1_HARD).println();
-    prob_d_t1_d_t1(t1, t2, TYPE_4_B1_HARD).println();
-    prob_d_t2_d_t2(t1, t2, TYPE_4_B1_HARD).println();
-    prob_d_t1_d_t2(t1, t2, TYPE_4_B1_HARD).println();*/
+    Arb d11, d22, d12;
+    prob_hessian(t1, t2, TYPE_4_B1_HARD, d11, d22, d12);
+    d11.println();
+    d22.println();
+    d12.println();*/
 
     //prob(0,0,TYPE_4_B1_HARD).println();
-    flint_printf("RESULT: %d\n", check(t2_range, t2_range, b_range));
+    BoxVerdict v = verify_box(Box{t2_range, t2_range, b_range},
+                              [](const Box &x) { return decide(x[0], x[1], x[2]); },
+                              split_widest, describe);
+    flint_printf("RESULT: %d\n", v == BOX_PROVEN);
     
+    escalate_print_stats();
+    biv_norm_fast_print_stats();
+    biv_norm_integ_print_stats();
+    biv_cache_print_stats();
+    biv_store_print_stats();
+    biv_model_print_stats();
+
     flint_cleanup_master();
 
     return 0;
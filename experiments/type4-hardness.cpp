@@ -7,6 +7,11 @@
 #include <cstdio>
 #include <cassert>
 #include "max2sat.hpp"
+#include "args.hpp"
+#include "verify.hpp"
+#include "biv_cache.hpp"
+#include "biv_store.hpp"
+#include "biv_model.hpp"
 #include "constants.hpp"
 #define NUM_THREADS 1
 
@@ -29,52 +34,37 @@ Arb eval_norm(const Arb &t1, const Arb &t2) {
 }
 
 
-int check(const Arb &t1, const Arb &t2) {
+BoxVerdict decide(const Arb &t1, const Arb &t2) {
     if (Arb::abs(t1 - TYPE_4_T1) < TYPE_4_T_EPS &&
         Arb::abs(t2 - TYPE_4_T2) < TYPE_4_T_EPS) {
         // too close, so stop
-        return 1;
+        return BOX_PROVEN;
     }
 
     if (t1 < TYPE_4_T_EPS && t2 < TYPE_4_T_EPS) {
-        return 1;
+        return BOX_PROVEN;
     }
     
     if (1 - t1 < TYPE_4_T_EPS && 1 - t2 < TYPE_4_T_EPS) {
-        return 1;
+        return BOX_PROVEN;
     }
 
     if (eval_norm(t1, t2) < TYPE_4_HARD_BOUND) {
-        return 1;
+        return BOX_PROVEN;
     }
 
-    // otherwise we need to split
-    Arb rt1 = t1.rad();
-    Arb rt2 = t2.rad();
-
-    flint_printf("AT: \n");
-    t1.println();
-    t2.println();
-    eval_norm(t1, t2).println();
+    return BOX_UNDECIDED;
+}
 
-    if (rt1 >= rt2) {
-#ifdef DEBUG
-        flint_printf("SPLIT: t1\n");
-#endif
-        return check(t1.left_half(), t2) && check(t1.right_half(), t2);
-    }
-    else {
-#ifdef DEBUG
-        flint_printf("SPLIT: t2\n");
-#endif
-        return check(t1, t2.left_half()) &&
-                        check(t1, t2.right_half());
-    }
+// written to the report if the search fails at x
+void describe(FILE* out, const Box &x) {
+    verify_fprint(out, "eval_norm", eval_norm(x[0], x[1]));
 }
 
 int main(int argc, char* argv[]) {
     
     flint_set_num_threads(NUM_THREADS);
+    parse_common_args(argc, argv);
     
     //(1/(1-eval_low(0.1489, 0.1489))).println();
     //(1/(1-eval_low(-0.1489, -0.1489))).println();
@@ -135,8 +125,24 @@ int main(int argc, char* argv[]) {
 
     flint_printf("Type 4, hardness\n");
 
-    flint_printf("RESULT: %d\n", check(t2_range, t2_range));
+    // report each undecided box before splitting it
+    auto split = [](const Box &x) {
+        flint_printf("AT: \n");
+        x.println();
+        eval_norm(x[0], x[1]).println();
+        return x.widest();
+    };
+    BoxVerdict v = verify_box(Box{t2_range, t2_range},
+                              [](const Box &x) { return decide(x[0], x[1]); }, split, describe);
+    flint_printf("RESULT: %d\n", v == BOX_PROVEN);
     
+    escalate_print_stats();
+    biv_norm_fast_print_stats();
+    biv_norm_integ_print_stats();
+    biv_cache_print_stats();
+    biv_store_print_stats();
+    biv_model_print_stats();
+
     flint_cleanup_master();
 
     return 0;
@@ -6,7 +6,13 @@
 
 #include <cstdio>
 #include <cassert>
+#include <mutex>
 #include "max2sat.hpp"
+#include "args.hpp"
+#include "verify.hpp"
+#include "biv_cache.hpp"
+#include "biv_store.hpp"
+#include "biv_model.hpp"
 #include "constants.hpp"
 #define NUM_THREADS 1
 
@@ -18,47 +24,56 @@ Arb vol(const Arb &a, const Arb &b, const Arb &c) {
     return a.rad() * b.rad() * c.rad();
 }
 
+// decide() runs on every search thread
+std::mutex est_mutex;
+
+void add_vol(Arb &est, const Arb &a, const Arb &b, const Arb &c) {
+    Arb v = vol(a, b, c);
+    std::lock_guard<std::mutex> lock(est_mutex);
+    est = est + v;
+}
+
 Arb obj(const Arb &b1, const Arb &b2, const Arb &rho) {
 //    Max2Sat::prob_from_rel(b1, b2, rho, 1).pretty_println();
 //    Max2Sat::value_from_rel(b1, b2, rho).pretty_println();
     return Max2Sat::prob_from_rel(b1, b2, rho, 1) - Max2Sat::value_from_rel(b1, b2, rho); 
 }
 
-Arb obj_d_b1(const Arb &b1, const Arb &b2, const Arb &rho) {
-    return Max2Sat::prob_from_rel_d_b1(b1, b2, rho, 1) - Max2Sat::value_from_rel_d_b1(b1, b2, rho); 
-}
-
-Arb obj_d_b2(const Arb &b1, const Arb &b2, const Arb &rho) {
-    return Max2Sat::prob_from_rel_d_b2(b1, b2, rho, 1) - Max2Sat::value_from_rel_d_b2(b1, b2, rho); 
-}
-
-Arb obj_d_rho(const Arb &b1, const Arb &b2, const Arb &rho) {
-    return Max2Sat::prob_from_rel_d_rho(b1, b2, rho, 1) - Max2Sat::value_from_rel_d_rho(b1, b2, rho); 
+// the partials of obj; its value is left 0, obj() has it
+Gradient3 obj_grad(const Arb &b1, const Arb &b2, const Arb &rho) {
+    Gradient3 p = Max2Sat::prob_from_rel_grad(b1, b2, rho, 1);
+    Gradient3 v = Max2Sat::value_from_rel_grad(b1, b2, rho);
+    Gradient3 g;
+    g.x = p.x - v.x;
+    g.y = p.y - v.y;
+    g.z = p.z - v.z;
+    return g;
 }
 
 
-int check(const Arb &b1, const Arb &b2, const Arb &rho) {
+BoxVerdict decide(const Arb &b1, const Arb &b2, const Arb &rho) {
     // int t = Config::tri_check_rel_rho(b1, b2, rho);
 
     Arb b12 = Config::b12_from_rel_rho(b1, b2, rho);
 
     if (b12 < -1 + Arb::abs(b1 + b2)) {
         // invalid region, so "good" by default
-        tri_est = tri_est + vol(b1, b2, rho);
-        return 1;
+        add_vol(tri_est, b1, b2, rho);
+        return BOX_PROVEN;
     }
 
     if (obj(b1, b2, rho) >= OBJ_HI) {
         //(1/(1-obj(b1, b2, rho))).println();
-        vol_est = vol_est + vol(b1, b2, rho);
-        return 1;
+        add_vol(vol_est, b1, b2, rho);
+        return BOX_PROVEN;
     }
 
     // derivative checks
     if (b12 < 1 - Arb::abs(b1 - b2)) {
-        Arb d_b1 = obj_d_b1(b1, b2, rho);
-        Arb d_b2 = obj_d_b2(b1, b2, rho);
-        Arb d_rho = obj_d_rho(b1, b2, rho);
+        Gradient3 g = obj_grad(b1, b2, rho);
+        Arb d_b1 = g.x;
+        Arb d_b2 = g.y;
+        Arb d_rho = g.z;
         
 #ifdef DEBUG
         flint_printf("PARTIALS\n");
@@ -68,63 +83,35 @@ int check(const Arb &b1, const Arb &b2, const Arb &rho) {
 #endif
         
         if (!b1.is_nan() && (d_b1 > 0 || d_b1 < 0)) {
-            excl_est = excl_est + vol(b1, b2, rho);
-            return 1;
+            add_vol(excl_est, b1, b2, rho);
+            return BOX_PROVEN;
         }
         else if (!b2.is_nan() && (d_b2 > 0 || d_b2 < 0)) {
-            excl_est = excl_est + vol(b1, b2, rho);
-            return 1;
+            add_vol(excl_est, b1, b2, rho);
+            return BOX_PROVEN;
         }
         else if (!rho.is_nan() && (d_rho > 0 || d_rho < 0)) {
-            excl_est = excl_est + vol(b1, b2, rho);
-            return 1;
+            add_vol(excl_est, b1, b2, rho);
+            return BOX_PROVEN;
         }   
     }
 
+    return BOX_UNDECIDED;
+}
 
-#ifdef DEBUG
-    flint_printf("AT :\n");
-    b1.println();
-    b2.println();
-    rho.println();
-    flint_printf("VOL : ");
-    vol_est.println();
-    flint_printf("TRI : ");
-    tri_est.println();
-    flint_printf("EXCL: ");
-    excl_est.println();
-#endif
-
-    // otherwise we need to split
-    Arb rb1 = b1.rad();
-    Arb rb2 = b2.rad();
-    Arb rrho = rho.rad();
-
-    if (rb1 >= rb2 && rb1 >= rrho) {
-#ifdef DEBUG
-        flint_printf("SPLIT: b1\n");
-#endif
-        return check(b1.left_half(), b2, rho) && check(b1.right_half(), b2, rho);
-    }
-    else if (rb2 >= rrho) {
-#ifdef DEBUG
-        flint_printf("SPLIT: b2\n");
-#endif
-        return check(b1, b2.left_half(), rho) &&
-                        check(b1, b2.right_half(), rho);
-    }
-    else {
-#ifdef DEBUG
-        flint_printf("SPLIT: rho\n");
-#endif
-        return check(b1, b2, rho.left_half()) &&
-                        check(b1, b2, rho.right_half());
-    }
+// written to the report if the search fails at x
+void describe(FILE* out, const Box &x) {
+    Gradient3 g = obj_grad(x[0], x[1], x[2]);
+    verify_fprint(out, "obj", obj(x[0], x[1], x[2]));
+    verify_fprint(out, "d_b1", g.x);
+    verify_fprint(out, "d_b2", g.y);
+    verify_fprint(out, "d_rho", g.z);
 }
 
 int main(int argc, char* argv[]) {
     
     flint_set_num_threads(NUM_THREADS);
+    parse_common_args(argc, argv);
     
     /*
     Arb b1(-0.1);
@@ -145,13 +132,13 @@ int main(int argc, char* argv[]) {
     Arb ob_d_rho_est = (obj(b1, b2, rho+eps) - obj(b1, b2, rho)) / eps;
 
     ob_d_b1_est.println();
-    obj_d_b1(b1, b2, rho).println();
+    obj_grad(b1, b2, rho).x.println();
 
     ob_d_b2_est.println();
-    obj_d_b2(b1, b2, rho).println();
+    obj_grad(b1, b2, rho).y.println();
 
     ob_d_rho_est.println();
-    obj_d_rho(b1, b2, rho).println();
+    obj_grad(b1, b2, rho).z.println();
     */
 
     Arb b1_range(-1, 1);
@@ -178,7 +165,10 @@ int main(int argc, char* argv[]) {
 
     flint_printf("Step 1: gradient nonzero everywhere (or easy to approx)\n");
 
-    flint_printf("RESULT: %d\n", check(b1_range, b2_range, rho_range));
+    BoxVerdict v = verify_box(Box{b1_range, b2_range, rho_range},
+                              [](const Box &x) { return decide(x[0], x[1], x[2]); },
+                              split_widest, describe);
+    flint_printf("RESULT: %d\n", v == BOX_PROVEN);
 
     flint_printf("VOL : ");
     vol_est.println();
@@ -187,6 +177,13 @@ int main(int argc, char* argv[]) {
     flint_printf("EXCL: ");
     excl_est.println();
     
+    escalate_print_stats();
+    biv_norm_fast_print_stats();
+    biv_norm_integ_print_stats();
+    biv_cache_print_stats();
+    biv_store_print_stats();
+    biv_model_print_stats();
+
     flint_cleanup_master();
 
     return 0;
@@ -7,6 +7,11 @@
 #include <cstdio>
 #include <cassert>
 #include "max2sat.hpp"
+#include "args.hpp"
+#include "verify.hpp"
+#include "biv_cache.hpp"
+#include "biv_store.hpp"
+#include "biv_model.hpp"
 #include "constants.hpp"
 #define NUM_THREADS 1
 
@@ -17,16 +22,15 @@ Arb obj(const Arb &b1, const Arb &b2, const Arb &rho) {
     return Max2Sat::prob_from_rel(b1, b2, rho, 1) - Max2Sat::value_from_rel(b1, b2, rho); 
 }
 
-Arb obj_d_b1(const Arb &b1, const Arb &b2, const Arb &rho) {
-    return Max2Sat::prob_from_rel_d_b1(b1, b2, rho, 1) - Max2Sat::value_from_rel_d_b1(b1, b2, rho); 
-}
-
-Arb obj_d_b2(const Arb &b1, const Arb &b2, const Arb &rho) {
-    return Max2Sat::prob_from_rel_d_b2(b1, b2, rho, 1) - Max2Sat::value_from_rel_d_b2(b1, b2, rho); 
-}
-
-Arb obj_d_rho(const Arb &b1, const Arb &b2, const Arb &rho) {
-    return Max2Sat::prob_from_rel_d_rho(b1, b2, rho, 1) - Max2Sat::value_from_rel_d_rho(b1, b2, rho); 
+// the partials of obj; its value is left 0, obj() has it
+Gradient3 obj_grad(const Arb &b1, const Arb &b2, const Arb &rho) {
+    Gradient3 p = Max2Sat::prob_from_rel_grad(b1, b2, rho, 1);
+    Gradient3 v = Max2Sat::value_from_rel_grad(b1, b2, rho);
+    Gradient3 g;
+    g.x = p.x - v.x;
+    g.y = p.y - v.y;
+    g.z = p.z - v.z;
+    return g;
 }
 
 
@@ -36,64 +40,53 @@ Arb eval_low(const Arb &b1, const Arb &b2) {
     return obj(b1, b2, rho);
 }
 
-Arb eval_low_pos_d_b1(const Arb &b1, const Arb &b2) {
-    Arb b12 = -1 + Arb::abs(b1 + b2);
-    Arb rho = Config::rho_safe(b1, b2, b12);
-
+Arb eval_low_pos_d_b1(const Arb &b1, const Arb &b2, const Gradient3 &g) {
     Arb x = Arb::safe_sqrt((1-b2) / (1 + b2));
     Arb y = 1 / ((1 + b1) * Arb::safe_sqrt(1 - b1.sqr()));
 
-    return obj_d_b1(b1, b2, rho) + obj_d_rho(b1, b2, rho) * x * y;
+    return g.x + g.z * x * y;
 }
 
-Arb eval_low_pos_d_b2(const Arb &b1, const Arb &b2) {
-    Arb b12 = -1 + Arb::abs(b1 + b2);
-    Arb rho = Config::rho_safe(b1, b2, b12);
-
+Arb eval_low_pos_d_b2(const Arb &b1, const Arb &b2, const Gradient3 &g) {
     Arb x = Arb::safe_sqrt((1-b1) / (1 + b1));
     Arb y = 1 / ((1 + b2) * Arb::safe_sqrt(1 - b2.sqr()));
 
-    return obj_d_b2(b1, b2, rho) + obj_d_rho(b1, b2, rho) * x * y;
+    return g.y + g.z * x * y;
 }
 
-Arb eval_low_neg_d_b1(const Arb &b1, const Arb &b2) {
-    Arb b12 = -1 + Arb::abs(b1 + b2);
-    Arb rho = Config::rho_safe(b1, b2, b12);
-
+Arb eval_low_neg_d_b1(const Arb &b1, const Arb &b2, const Gradient3 &g) {
     Arb x = Arb::safe_sqrt((1+b2) / (1 - b2));
     Arb y = 1 / ((1 - b1) * Arb::safe_sqrt(1 - b1.sqr()));
 
-    return obj_d_b1(b1, b2, rho) - obj_d_rho(b1, b2, rho) * x * y;
+    return g.x - g.z * x * y;
 }
 
-Arb eval_low_neg_d_b2(const Arb &b1, const Arb &b2) {
-    Arb b12 = -1 + Arb::abs(b1 + b2);
-    Arb rho = Config::rho_safe(b1, b2, b12);
-
+Arb eval_low_neg_d_b2(const Arb &b1, const Arb &b2, const Gradient3 &g) {
     Arb x = Arb::safe_sqrt((1+b1) / (1 - b1));
     Arb y = 1 / ((1 - b2) * Arb::safe_sqrt(1 - b2.sqr()));
 
-    return obj_d_b2(b1, b2, rho) - obj_d_rho(b1, b2, rho) * x * y;
+    return g.y - g.z * x * y;
 }
 
 
-int check(const Arb &b1, const Arb &b2) {
+BoxVerdict decide(const Arb &b1, const Arb &b2) {
     Arb b12 = -1 + Arb::abs(b1 + b2);
     Arb rho = Config::rho_safe(b1, b2, b12);
 
     if (obj(b1, b2, rho) >= OBJ_HI) {
         //(1/(1-obj(b1, b2, rho))).println();
-        return 1;
+        return BOX_PROVEN;
     }
 
     if (b1 + b2 < 0) {
         // Can ignore this case
-        return 1;
+        return BOX_PROVEN;
     }
 
     if (b1 + b2 > 0) {
-        Arb d_b1 = eval_low_pos_d_b1(b1, b2);
-        Arb d_b2 = eval_low_pos_d_b2(b1, b2);
+        Gradient3 g = obj_grad(b1, b2, rho);
+        Arb d_b1 = eval_low_pos_d_b1(b1, b2, g);
+        Arb d_b2 = eval_low_pos_d_b2(b1, b2, g);
         if(d_b1.is_nan()) {
             assert(!(d_b1 > 0));
             assert(!(d_b1 < 0));
@@ -103,47 +96,31 @@ int check(const Arb &b1, const Arb &b2) {
             assert(!(d_b2 < 0));
         }
         if (d_b1 > 0 || d_b1 < 0) {
-            return 1;
+            return BOX_PROVEN;
         }
         else if (d_b2 > 0 || d_b2 < 0) {
-            return 1;
+            return BOX_PROVEN;
         }
     }
 
     if (Arb::abs(b1 - TYPE_4_B1_HARD) < TYPE_4_EPS &&
         Arb::abs(b2 - TYPE_4_B2_HARD) < TYPE_4_EPS) {
         // SKIP
-        return 1;
+        return BOX_PROVEN;
     }
 
-    /* flint_printf("STUFF\n");
-    b1.println();
-    b2.println();
-    b12.println();
-    (1/(1-eval_low(b1, b2))).println(); */
-
-    // otherwise we need to split
-    Arb rb1 = b1.rad();
-    Arb rb2 = b2.rad();
+    return BOX_UNDECIDED;
+}
 
-    if (rb1 >= rb2) {
-#ifdef DEBUG
-        flint_printf("SPLIT: b1\n");
-#endif
-        return check(b1.left_half(), b2) && check(b1.right_half(), b2);
-    }
-    else {
-#ifdef DEBUG
-        flint_printf("SPLIT: b2\n");
-#endif
-        return check(b1, b2.left_half()) &&
-                        check(b1, b2.right_half());
-    }
+// written to the report if the search fails at x
+void describe(FILE* out, const Box &x) {
+    verify_fprint(out, "obj", eval_low(x[0], x[1]));
 }
 
 int main(int argc, char* argv[]) {
     
     flint_set_num_threads(NUM_THREADS);
+    parse_common_args(argc, argv);
     
     //(1/(1-eval_low(0.1489, 0.1489))).println();
     //(1/(1-eval_low(-0.1489, -0.1489))).println();
@@ -190,13 +167,13 @@ int main(int argc, char* argv[]) {
     Arb ob_d_rho_est = (obj(b1, b2, rho+eps) - obj(b1, b2, rho)) / eps;
 
     ob_d_b1_est.println();
-    obj_d_b1(b1, b2, rho).println();
+    obj_grad(b1, b2, rho).x.println();
 
     ob_d_b2_est.println();
-    obj_d_b2(b1, b2, rho).println();
+    obj_grad(b1, b2, rho).y.println();
 
     ob_d_rho_est.println();
-    obj_d_rho(b1, b2, rho).println();
+    obj_grad(b1, b2, rho).z.println();
     */
 
     Arb b1_range(-1, 1);
@@ -222,11 +199,21 @@ int main(int argc, char* argv[]) {
 
     flint_printf("Step 2: easy to approx on the boundary away from (%.10f, %.10f):\n", TYPE_4_B1_HARD, TYPE_4_B1_HARD);
 
-    flint_printf("RESULT: %d\n", check(b1_range, b2_range));
+    BoxVerdict v = verify_box(Box{b1_range, b2_range},
+                              [](const Box &x) { return decide(x[0], x[1]); },
+                              split_widest, describe);
+    flint_printf("RESULT: %d\n", v == BOX_PROVEN);
 
     flint_printf("UPPER BOUND on optimal ratio: "); (1/(1-eval_low(TYPE_4_B1_HARD, TYPE_4_B2_HARD))).println();
     //flint_printf("CHECK: %d\n", eval_low(TYPE_4_B1_HARD, TYPE_4_B2_HARD) < 1 - 1/0.9462);
     
+    escalate_print_stats();
+    biv_norm_fast_print_stats();
+    biv_norm_integ_print_stats();
+    biv_cache_print_stats();
+    biv_store_print_stats();
+    biv_model_print_stats();
+
     flint_cleanup_master();
 
     return 0;
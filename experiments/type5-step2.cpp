@@ -7,6 +7,11 @@
 #include <cstdio>
 #include <cassert>
 #include "max2sat.hpp"
+#include "args.hpp"
+#include "verify.hpp"
+#include "biv_cache.hpp"
+#include "biv_store.hpp"
+#include "biv_model.hpp"
 #include "constants.hpp"
 #define NUM_THREADS 1
 
@@ -18,19 +23,15 @@ Arb obj(const Arb &b1, const Arb &b2, const Arb &rho, const Arb &beta) {
         - beta * Max2Sat::value_from_rel(b1, b2, rho); 
 }
 
-Arb obj_d_b1(const Arb &b1, const Arb &b2, const Arb &rho, const Arb &beta) {
-    return Max2Sat::prob_from_rel_d_b1(b1, b2, rho, beta)
-        - beta * Max2Sat::value_from_rel_d_b1(b1, b2, rho); 
-}
-
-Arb obj_d_b2(const Arb &b1, const Arb &b2, const Arb &rho, const Arb &beta) {
-    return Max2Sat::prob_from_rel_d_b2(b1, b2, rho, beta)
-        - beta * Max2Sat::value_from_rel_d_b2(b1, b2, rho); 
-}
-
-Arb obj_d_rho(const Arb &b1, const Arb &b2, const Arb &rho, const Arb &beta) {
-    return Max2Sat::prob_from_rel_d_rho(b1, b2, rho, beta)
-        - beta *  Max2Sat::value_from_rel_d_rho(b1, b2, rho); 
+// the partials of obj; its value is left 0, obj() has it
+Gradient3 obj_grad(const Arb &b1, const Arb &b2, const Arb &rho, const Arb &beta) {
+    Gradient3 p = Max2Sat::prob_from_rel_grad(b1, b2, rho, beta);
+    Gradient3 v = Max2Sat::value_from_rel_grad(b1, b2, rho);
+    Gradient3 g;
+    g.x = p.x - beta * v.x;
+    g.y = p.y - beta * v.y;
+    g.z = p.z - beta * v.z;
+    return g;
 }
 
 Arb eval_low(const Arb &b1, const Arb &b2, const Arb &beta) {
@@ -39,56 +40,37 @@ Arb eval_low(const Arb &b1, const Arb &b2, const Arb &beta) {
     return obj(b1, b2, rho, beta);
 }
 
-Arb eval_low_pos_d_b1(const Arb &b1, const Arb &b2, const Arb &beta) {
-    Arb b12 = -1 + Arb::abs(b1 + b2);
-    Arb rho = Config::rho_safe(b1, b2, b12);
-
+Arb eval_low_pos_d_b1(const Arb &b1, const Arb &b2, const Gradient3 &g) {
     Arb x = Arb::safe_sqrt((1-b2) / (1 + b2));
     Arb y = 1 / ((1 + b1) * Arb::safe_sqrt(1 - b1.sqr()));
 
-    return obj_d_b1(b1, b2, rho, beta) + obj_d_rho(b1, b2, rho, beta) * x * y;
+    return g.x + g.z * x * y;
 }
 
-Arb eval_low_pos_d_b2(const Arb &b1, const Arb &b2, const Arb &beta) {
-    Arb b12 = -1 + Arb::abs(b1 + b2);
-    Arb rho = Config::rho_safe(b1, b2, b12);
-
+Arb eval_low_pos_d_b2(const Arb &b1, const Arb &b2, const Gradient3 &g) {
     Arb x = Arb::safe_sqrt((1-b1) / (1 + b1));
     Arb y = 1 / ((1 + b2) * Arb::safe_sqrt(1 - b2.sqr()));
 
-    return obj_d_b2(b1, b2, rho, beta) + obj_d_rho(b1, b2, rho, beta) * x * y;
+    return g.y + g.z * x * y;
 }
 
-int pos_check(const Arb &b1, const Arb &b2, const Arb &beta) {
+BoxVerdict pos_decide(const Arb &b1, const Arb &b2, const Arb &beta) {
     Arb b12 = -1 + Arb::abs(b1 + b2);
     Arb rho = Config::rho_safe(b1, b2, b12);
     Arb ob = obj(b1, b2, rho, beta);
 
     if (ob > 0) {
-        return 1;
+        return BOX_PROVEN;
     }
-
-    /*flint_printf("POS_CHECK\n");
-    b1.println();
-    b2.println();
-    ob.println();*/
-    
-    Arb rb1 = b1.rad();
-    Arb rb2 = b2.rad();
-
-    if (rb1 >= rb2) {
-        //flint_printf("SPLIT: b1\n");
-        return pos_check(b1.left_half(), b2, beta) &&
-            pos_check(b1.right_half(), b2, beta);
-    }
-    else {
-        //flint_printf("SPLIT: b2\n");
-        return pos_check(b1, b2.left_half(), beta) &&
-            pos_check(b1, b2.right_half(), beta);
+    if (ob < 0) {
+        // a point where the sign is wrong: no need to look further
+        return BOX_REFUTED;
     }
+
+    return BOX_UNDECIDED;
 }
 
-int check(const Arb &b1, const Arb &b2, const Arb &beta) {
+BoxVerdict decide(const Arb &b1, const Arb &b2, const Arb &beta) {
     Arb b12;
     b12 = -1 + Arb::abs(b1 + b2);
 
@@ -96,17 +78,18 @@ int check(const Arb &b1, const Arb &b2, const Arb &beta) {
 
     if (obj(b1, b2, rho, beta) > TYPE_5_LOWER_BOUND) {
         //(1/(1-obj(b1, b2, rho))).println();
-        return 1;
+        return BOX_PROVEN;
     }
 
     if (b1 + b2 < 0) {
         // Can ignore this case by symmetry
-        return 1;
+        return BOX_PROVEN;
     }
 
     if (b1 + b2 > 0) {
-        Arb d_b1 = eval_low_pos_d_b1(b1, b2, beta);
-        Arb d_b2 = eval_low_pos_d_b2(b1, b2, beta);
+        Gradient3 g = obj_grad(b1, b2, rho, beta);
+        Arb d_b1 = eval_low_pos_d_b1(b1, b2, g);
+        Arb d_b2 = eval_low_pos_d_b2(b1, b2, g);
         if(d_b1.is_nan()) {
             assert(!(d_b1 > 0));
             assert(!(d_b1 < 0));
@@ -116,17 +99,17 @@ int check(const Arb &b1, const Arb &b2, const Arb &beta) {
             assert(!(d_b2 < 0));
         }
         if (d_b1 > 0 || d_b1 < 0) {
-            return 1;
+            return BOX_PROVEN;
         }
         else if (d_b2 > 0 || d_b2 < 0) {
-            return 1;
+            return BOX_PROVEN;
         }
     }
 
     if (Arb::abs(b1 - TYPE_5_B1_HARD) < TYPE_5_EPS &&
         Arb::abs(b2 - TYPE_5_B2_HARD) < TYPE_5_EPS) {
         // SKIP as too close
-        return 1;
+        return BOX_PROVEN;
     }
 
 /*    flint_printf("STUFF\n");
@@ -138,34 +121,18 @@ int check(const Arb &b1, const Arb &b2, const Arb &beta) {
 
     //assert(!(obj(b1, b2, rho, beta) < 0));
 
-    // otherwise we need to split
-    Arb rb1 = b1.rad();
-    Arb rb2 = b2.rad();
-    Arb rbeta = beta.rad();
-
-    if (rb1 >= rb2 && rb1 >= rbeta) {
-#ifdef DEBUG
-        flint_printf("SPLIT: b1\n");
-#endif
-        return check(b1.left_half(), b2, beta) &&
-            check(b1.right_half(), b2, beta);
-    }
-    else if (rb2 >= rbeta) {
-#ifdef DEBUG
-        flint_printf("SPLIT: b2\n");
-#endif
-        return check(b1, b2.left_half(), beta) &&
-            check(b1, b2.right_half(), beta);
-    }
-    else {
-        return check(b1, b2, beta.left_half()) &&
-            check(b1, b2, beta.right_half());
-    }
+    return BOX_UNDECIDED;
+}
+
+// written to the report if the search fails at x
+void describe(FILE* out, const Box &x) {
+    verify_fprint(out, "obj", eval_low(x[0], x[1], x[2]));
 }
 
 int main(int argc, char* argv[]) {
     
     flint_set_num_threads(NUM_THREADS);
+    parse_common_args(argc, argv);
     
     //(1/(1-eval_low(0.1489, 0.1489))).println();
     //(1/(1-eval_low(-0.1489, -0.1489))).println();
@@ -176,11 +143,12 @@ int main(int argc, char* argv[]) {
     Arb x = eval_low(b1, b2, beta);
     Arb y = eval_low(b1 + eps, b2, beta);
     Arb z = eval_low(b1, b2 + eps, beta);
+    Gradient3 g = obj_grad(b1, b2, Config::rho_safe(b1, b2, -1 + Arb::abs(b1 + b2)), beta);
     ((y - x) / eps).println();
-    eval_low_pos_d_b1(b1, b2, beta).println();
+    eval_low_pos_d_b1(b1, b2, g).println();
 
     ((z - x) / eps).println();
-    eval_low_pos_d_b2(b1, b2, beta).println();
+    eval_low_pos_d_b2(b1, b2, g).println();
 
     /* Arb bb1(-.2);
     Arb bb2(-.3);
@@ -213,13 +181,13 @@ int main(int argc, char* argv[]) {
     Arb ob_d_rho_est = (obj(b1, b2, rho+eps) - obj(b1, b2, rho)) / eps;
 
     ob_d_b1_est.println();
-    obj_d_b1(b1, b2, rho).println();
+    obj_grad(b1, b2, rho).x.println();
 
     ob_d_b2_est.println();
-    obj_d_b2(b1, b2, rho).println();
+    obj_grad(b1, b2, rho).y.println();
 
     ob_d_rho_est.println();
-    obj_d_rho(b1, b2, rho).println();
+    obj_grad(b1, b2, rho).z.println();
     */
 
     Arb b1_range(-1, 1);
@@ -246,15 +214,30 @@ int main(int argc, char* argv[]) {
 
     flint_printf("Step 2: easy to approx on the boundary away from (%f, %f):\n", TYPE_5_B1_HARD, TYPE_5_B2_HARD);
 
-    flint_printf("RESULT: %d\n", check(b1_range, b2_range, beta_range));
+    BoxVerdict v = verify_box(Box{b1_range, b2_range, beta_range},
+                              [](const Box &x) { return decide(x[0], x[1], x[2]); },
+                              split_widest, describe);
+    flint_printf("RESULT: %d\n", v == BOX_PROVEN);
 
     flint_printf("NEG SIGN AT %.10f: %d\n", TYPE_5_BETA_HI,
                  eval_low(TYPE_5_B1_HARD, TYPE_5_B2_HARD,TYPE_5_BETA_HI) < 0);
-    flint_printf("POS SIGN AT %.10f: %d\n", TYPE_5_BETA_LO,
-                 pos_check(Arb(TYPE_5_B1_HARD-2*TYPE_5_EPS, TYPE_5_B1_HARD+2*TYPE_5_EPS),
-                           Arb(TYPE_5_B2_HARD-2*TYPE_5_EPS, TYPE_5_B2_HARD+2*TYPE_5_EPS), TYPE_5_BETA_LO));
+    Box hard{Arb(TYPE_5_B1_HARD-2*TYPE_5_EPS, TYPE_5_B1_HARD+2*TYPE_5_EPS),
+             Arb(TYPE_5_B2_HARD-2*TYPE_5_EPS, TYPE_5_B2_HARD+2*TYPE_5_EPS)};
+    auto pos_describe = [](FILE* out, const Box &x) {
+        verify_fprint(out, "obj", eval_low(x[0], x[1], TYPE_5_BETA_LO));
+    };
+    BoxVerdict pos = verify_box(hard, [](const Box &x) { return pos_decide(x[0], x[1], TYPE_5_BETA_LO); },
+                                split_widest, pos_describe);
+    flint_printf("POS SIGN AT %.10f: %d\n", TYPE_5_BETA_LO, pos == BOX_PROVEN);
 
     
+    escalate_print_stats();
+    biv_norm_fast_print_stats();
+    biv_norm_integ_print_stats();
+    biv_cache_print_stats();
+    biv_store_print_stats();
+    biv_model_print_stats();
+
     flint_cleanup_master();
 
     return 0;
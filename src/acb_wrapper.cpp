@@ -7,6 +7,7 @@
 #include "acb_wrapper.hpp"
 #include "acb_hypgeom.h"
 #include <cassert>
+#include <utility>
 
 // constructors
 
@@ -45,6 +46,26 @@ Acb::Acb(const acb_t z) {
     acb_set(this -> t, z);
 }
 
+Acb::Acb(const Acb& z) {
+    acb_init(this -> t);
+    acb_set(this -> t, z.t);
+}
+
+Acb::Acb(Acb&& z) noexcept {
+    acb_init(this -> t);
+    acb_swap(this -> t, z.t);
+}
+
+Acb& Acb::operator=(const Acb& rhs) {
+    acb_set(this -> t, rhs.t);
+    return *this;
+}
+
+Acb& Acb::operator=(Acb&& rhs) noexcept {
+    acb_swap(this -> t, rhs.t);
+    return *this;
+}
+
 // destructor
 
 Acb::~Acb() {
@@ -76,16 +97,25 @@ int Acb::is_real() const {
 }
 
 
-Acb Acb::join(const Acb& rhs) const {
+Acb Acb::join(const Acb& rhs) const & {
     Acb ans;
-    acb_union(ans.t, this -> t, rhs.t, GLOBAL_PRECISION);
+    acb_union(ans.t, this -> t, rhs.t, Precision::get());
     return ans;
 }
 
+Acb Acb::join(const Acb& rhs) && {
+    acb_union(this -> t, this -> t, rhs.t, Precision::get());
+    return std::move(*this);
+}
+
 Acb Acb::join(const Acb& lhs, const Acb& rhs) {
     return lhs.join(rhs);
 }
 
+Acb Acb::join(Acb&& lhs, const Acb& rhs) {
+    return std::move(lhs).join(rhs);
+}
+
 Acb Acb::nan() {
     Acb ans;
     acb_indeterminate(ans.t);
@@ -98,160 +128,452 @@ int Acb::is_nan() const {
 
 // operators
 
-Acb Acb::operator+(const Acb& rhs) const {
+Acb Acb::operator+(const Acb& rhs) const & {
     Acb ans;
-    acb_add(ans.t, this->t, rhs.t, GLOBAL_PRECISION);
+    acb_add(ans.t, this->t, rhs.t, Precision::get());
     return ans;
 }
 
-Acb Acb::operator-(const Acb& rhs) const {
+Acb Acb::operator-(const Acb& rhs) const & {
     Acb ans;
-    acb_sub(ans.t, this->t, rhs.t, GLOBAL_PRECISION);
+    acb_sub(ans.t, this->t, rhs.t, Precision::get());
     return ans;
 }
 
-Acb Acb::operator*(const Acb& rhs) const {
+Acb Acb::operator*(const Acb& rhs) const & {
     Acb ans;
-    acb_mul(ans.t, this->t, rhs.t, GLOBAL_PRECISION);
+    acb_mul(ans.t, this->t, rhs.t, Precision::get());
     return ans;
 }
 
-Acb Acb::operator/(const Acb& rhs) const {
+Acb Acb::operator/(const Acb& rhs) const & {
     Acb ans;
-    acb_div(ans.t, this->t, rhs.t, GLOBAL_PRECISION);
+    acb_div(ans.t, this->t, rhs.t, Precision::get());
     return ans;
 }
 
+Acb Acb::operator+(const Acb& rhs) && {
+    acb_add(this->t, this->t, rhs.t, Precision::get());
+    return std::move(*this);
+}
+
+Acb Acb::operator-(const Acb& rhs) && {
+    acb_sub(this->t, this->t, rhs.t, Precision::get());
+    return std::move(*this);
+}
+
+Acb Acb::operator*(const Acb& rhs) && {
+    acb_mul(this->t, this->t, rhs.t, Precision::get());
+    return std::move(*this);
+}
+
+Acb Acb::operator/(const Acb& rhs) && {
+    acb_div(this->t, this->t, rhs.t, Precision::get());
+    return std::move(*this);
+}
+
+Acb Acb::operator+(Acb&& rhs) const & {
+    acb_add(rhs.t, this->t, rhs.t, Precision::get());
+    return std::move(rhs);
+}
+
+Acb Acb::operator-(Acb&& rhs) const & {
+    acb_sub(rhs.t, this->t, rhs.t, Precision::get());
+    return std::move(rhs);
+}
+
+Acb Acb::operator*(Acb&& rhs) const & {
+    acb_mul(rhs.t, this->t, rhs.t, Precision::get());
+    return std::move(rhs);
+}
+
+Acb Acb::operator/(Acb&& rhs) const & {
+    acb_div(rhs.t, this->t, rhs.t, Precision::get());
+    return std::move(rhs);
+}
+
+Acb Acb::operator+(Acb&& rhs) && {
+    return std::move(*this) + static_cast<const Acb&>(rhs);
+}
+
+Acb Acb::operator-(Acb&& rhs) && {
+    return std::move(*this) - static_cast<const Acb&>(rhs);
+}
+
+Acb Acb::operator*(Acb&& rhs) && {
+    return std::move(*this) * static_cast<const Acb&>(rhs);
+}
+
+Acb Acb::operator/(Acb&& rhs) && {
+    return std::move(*this) / static_cast<const Acb&>(rhs);
+}
+
+Acb Acb::operator+(double rhs) const & {
+    Acb ans;
+    _acb_add_d(ans.t, this->t, rhs, Precision::get());
+    return ans;
+}
+
+Acb Acb::operator-(double rhs) const & {
+    Acb ans;
+    _acb_sub_d(ans.t, this->t, rhs, Precision::get());
+    return ans;
+}
+
+Acb Acb::operator*(double rhs) const & {
+    Acb ans;
+    _acb_mul_d(ans.t, this->t, rhs, Precision::get());
+    return ans;
+}
+
+Acb Acb::operator/(double rhs) const & {
+    Acb ans;
+    _acb_div_d(ans.t, this->t, rhs, Precision::get());
+    return ans;
+}
+
+Acb Acb::operator+(double rhs) && {
+    _acb_add_d(this->t, this->t, rhs, Precision::get());
+    return std::move(*this);
+}
+
+Acb Acb::operator-(double rhs) && {
+    _acb_sub_d(this->t, this->t, rhs, Precision::get());
+    return std::move(*this);
+}
+
+Acb Acb::operator*(double rhs) && {
+    _acb_mul_d(this->t, this->t, rhs, Precision::get());
+    return std::move(*this);
+}
+
+Acb Acb::operator/(double rhs) && {
+    _acb_div_d(this->t, this->t, rhs, Precision::get());
+    return std::move(*this);
+}
+
+
 Acb operator+(double lhs, const Acb& rhs) {
-    Acb x(lhs);
-    return x + rhs;
+    return rhs + lhs;
 }
 
 Acb operator-(double lhs, const Acb& rhs) {
-    Acb x(lhs);
-    return x - rhs;
+    Acb ans;
+    _acb_d_sub(ans.t, lhs, rhs.t, Precision::get());
+    return ans;
 }
 
 Acb operator*(double lhs, const Acb& rhs) {
-    Acb x(lhs);
-    return x * rhs;
+    return rhs * lhs;
 }
 
 Acb operator/(double lhs, const Acb& rhs) {
-    Acb x(lhs);
-    return x / rhs;
+    Acb ans;
+    _acb_d_div(ans.t, lhs, rhs.t, Precision::get());
+    return ans;
+}
+
+Acb operator+(double lhs, Acb&& rhs) {
+    return std::move(rhs) + lhs;
+}
+
+Acb operator-(double lhs, Acb&& rhs) {
+    _acb_d_sub(rhs.t, lhs, rhs.t, Precision::get());
+    return std::move(rhs);
+}
+
+Acb operator*(double lhs, Acb&& rhs) {
+    return std::move(rhs) * lhs;
+}
+
+Acb operator/(double lhs, Acb&& rhs) {
+    _acb_d_div(rhs.t, lhs, rhs.t, Precision::get());
+    return std::move(rhs);
 }
 
 Acb operator+(const Arb& lhs, const Acb& rhs) {
-    Acb x(lhs);
-    return x + rhs;
+    Acb ans;
+    acb_add_arb(ans.t, rhs.t, lhs.t, Precision::get());
+    return ans;
 }
 
 Acb operator-(const Arb& lhs, const Acb& rhs) {
-    Acb x(lhs);
-    return x - rhs;
+    Acb ans;
+    acb_sub_arb(ans.t, rhs.t, lhs.t, Precision::get());
+    acb_neg(ans.t, ans.t);
+    return ans;
 }
 
 Acb operator*(const Arb& lhs, const Acb& rhs) {
-    Acb x(lhs);
-    return x * rhs;
+    Acb ans;
+    acb_mul_arb(ans.t, rhs.t, lhs.t, Precision::get());
+    return ans;
 }
 
 Acb operator/(const Arb& lhs, const Acb& rhs) {
     Acb x(lhs);
-    return x / rhs;
+    return std::move(x) / rhs;
+}
+
+Acb operator+(const Arb& lhs, Acb&& rhs) {
+    acb_add_arb(rhs.t, rhs.t, lhs.t, Precision::get());
+    return std::move(rhs);
+}
+
+Acb operator-(const Arb& lhs, Acb&& rhs) {
+    acb_sub_arb(rhs.t, rhs.t, lhs.t, Precision::get());
+    acb_neg(rhs.t, rhs.t);
+    return std::move(rhs);
+}
+
+Acb operator*(const Arb& lhs, Acb&& rhs) {
+    acb_mul_arb(rhs.t, rhs.t, lhs.t, Precision::get());
+    return std::move(rhs);
+}
+
+Acb operator/(const Arb& lhs, Acb&& rhs) {
+    Acb x(lhs);
+    return x / std::move(rhs);
+}
+
+// scalar kernels
+// the real and imaginary parts go through the Arb kernels
+
+void _acb_add_d(acb_t res, const acb_t x, double d, slong prec) {
+    _arb_add_d(acb_realref(res), acb_realref(x), d, prec);
+    arb_set(acb_imagref(res), acb_imagref(x));
+}
+
+void _acb_sub_d(acb_t res, const acb_t x, double d, slong prec) {
+    _arb_sub_d(acb_realref(res), acb_realref(x), d, prec);
+    arb_set(acb_imagref(res), acb_imagref(x));
+}
+
+void _acb_mul_d(acb_t res, const acb_t x, double d, slong prec) {
+    _arb_mul_d(acb_realref(res), acb_realref(x), d, prec);
+    _arb_mul_d(acb_imagref(res), acb_imagref(x), d, prec);
+}
+
+void _acb_div_d(acb_t res, const acb_t x, double d, slong prec) {
+    _arb_div_d(acb_realref(res), acb_realref(x), d, prec);
+    _arb_div_d(acb_imagref(res), acb_imagref(x), d, prec);
+}
+
+void _acb_d_sub(acb_t res, double d, const acb_t x, slong prec) {
+    _arb_d_sub(acb_realref(res), d, acb_realref(x), prec);
+    arb_neg(acb_imagref(res), acb_imagref(x));
+}
+
+void _acb_d_div(acb_t res, double d, const acb_t x, slong prec) {
+    slong n;
+    if (_d_is_pow2(d, n)) {
+        acb_inv(res, x, prec);
+        acb_mul_2exp_si(res, res, n);
+        if (d < 0) {
+            acb_neg(res, res);
+        }
+    }
+    else {
+        acb_t y;
+        acb_init(y);
+        acb_set_d(y, d);
+        acb_div(res, y, x, prec);
+        acb_clear(y);
+    }
 }
 
 // mathematical constants and functions
 
 Acb Acb::pi() {
     Acb ans;
-    acb_const_pi(ans.t, GLOBAL_PRECISION);
+    acb_set_arb(ans.t, _arb_const(ARB_CONST_PI, Precision::get()));
     return ans;
 }
 
-Acb Acb::exp() const {
+Acb Acb::exp() const & {
     Acb ans;
-    acb_exp(ans.t, this -> t, GLOBAL_PRECISION);
+    acb_exp(ans.t, this -> t, Precision::get());
     return ans;
 }
 
+Acb Acb::exp() && {
+    acb_exp(this -> t, this -> t, Precision::get());
+    return std::move(*this);
+}
+
 Acb Acb::exp(const Acb& x) {
     return x.exp();
 }
 
-Acb Acb::sqrt() const {
+Acb Acb::exp(Acb&& x) {
+    return std::move(x).exp();
+}
+
+Acb Acb::sqrt() const & {
     Acb ans;
-    acb_sqrt(ans.t, this -> t, GLOBAL_PRECISION);
+    acb_sqrt(ans.t, this -> t, Precision::get());
     return ans;
 }
 
+Acb Acb::sqrt() && {
+    acb_sqrt(this -> t, this -> t, Precision::get());
+    return std::move(*this);
+}
+
 Acb Acb::sqrt(const Acb& x) {
     return x.sqrt();
 }
 
-Acb Acb::sqrt_analytic(int analytic) const {
+Acb Acb::sqrt(Acb&& x) {
+    return std::move(x).sqrt();
+}
+
+Acb Acb::sqrt_analytic(int analytic) const & {
     Acb ans;
-    acb_sqrt_analytic(ans.t, this -> t, analytic, GLOBAL_PRECISION);
+    acb_sqrt_analytic(ans.t, this -> t, analytic, Precision::get());
     return ans;
 }
 
+Acb Acb::sqrt_analytic(int analytic) && {
+    acb_sqrt_analytic(this -> t, this -> t, analytic, Precision::get());
+    return std::move(*this);
+}
+
 Acb Acb::sqrt_analytic(const Acb& x, int analytic) {
     return x.sqrt_analytic(analytic);
 }
 
-Acb Acb::sqr() const {
+Acb Acb::sqrt_analytic(Acb&& x, int analytic) {
+    return std::move(x).sqrt_analytic(analytic);
+}
+
+Acb Acb::sqr() const & {
     Acb ans;
-    acb_sqr(ans.t, this -> t, GLOBAL_PRECISION);
+    acb_sqr(ans.t, this -> t, Precision::get());
     return ans;
 }
 
+Acb Acb::sqr() && {
+    acb_sqr(this -> t, this -> t, Precision::get());
+    return std::move(*this);
+}
+
 Acb Acb::sqr(const Acb& x) {
     return x.sqr();
 }
 
-Acb Acb::pow(const Acb& rhs) const {
+Acb Acb::sqr(Acb&& x) {
+    return std::move(x).sqr();
+}
+
+Acb Acb::pow(const Acb& rhs) const & {
     Acb ans;
-    acb_pow(ans.t, this -> t, rhs.t, GLOBAL_PRECISION);
+    acb_pow(ans.t, this -> t, rhs.t, Precision::get());
     return ans;
 }
 
+Acb Acb::pow(const Acb& rhs) && {
+    acb_pow(this -> t, this -> t, rhs.t, Precision::get());
+    return std::move(*this);
+}
+
 Acb Acb::pow(const Acb& lhs, const Acb& rhs) {
     return lhs.pow(rhs);
 }
 
-Acb Acb::pow_analytic(const Acb& rhs, int analytic) const {
+Acb Acb::pow(Acb&& lhs, const Acb& rhs) {
+    return std::move(lhs).pow(rhs);
+}
+
+Acb Acb::pow_analytic(const Acb& rhs, int analytic) const & {
     Acb ans;
-    acb_pow_analytic(ans.t, this -> t, rhs.t, analytic, GLOBAL_PRECISION);
+    acb_pow_analytic(ans.t, this -> t, rhs.t, analytic, Precision::get());
     return ans;
 }
 
+Acb Acb::pow_analytic(const Acb& rhs, int analytic) && {
+    acb_pow_analytic(this -> t, this -> t, rhs.t, analytic, Precision::get());
+    return std::move(*this);
+}
+
 Acb Acb::pow_analytic(const Acb& lhs, const Acb& rhs, int analytic) {
     return lhs.pow_analytic(rhs, analytic);
 }
 
-Acb Acb::erf() const {
+Acb Acb::pow_analytic(Acb&& lhs, const Acb& rhs, int analytic) {
+    return std::move(lhs).pow_analytic(rhs, analytic);
+}
+
+Acb Acb::erf() const & {
     Acb ans;
-    acb_hypgeom_erf(ans.t, this -> t, GLOBAL_PRECISION);
+    acb_hypgeom_erf(ans.t, this -> t, Precision::get());
     return ans;
 }
 
+Acb Acb::erf() && {
+    acb_hypgeom_erf(this -> t, this -> t, Precision::get());
+    return std::move(*this);
+}
+
 Acb Acb::erf(const Acb& x) {
     return x.erf();
 }
 
-Acb Acb::norm_pdf() const {
-    return exp((this->sqr()) / (-2)) / sqrt(2*pi());
+Acb Acb::erf(Acb&& x) {
+    return std::move(x).erf();
+}
+
+// exp(-z^2/2) / sqrt(2*pi)
+static void _acb_norm_pdf(acb_t res, const acb_t z, slong prec) {
+    acb_sqr(res, z, prec);
+    acb_mul_2exp_si(res, res, -1);
+    acb_neg(res, res);
+    acb_exp(res, res, prec);
+    acb_mul_arb(res, res, _arb_const(ARB_CONST_INV_SQRT_2PI, prec), prec);
+}
+
+// (1 + erf(z/sqrt(2)))/2
+static void _acb_norm_cdf(acb_t res, const acb_t z, slong prec) {
+    acb_mul_arb(res, z, _arb_const(ARB_CONST_INV_SQRT2, prec), prec);
+    acb_hypgeom_erf(res, res, prec);
+    acb_add_si(res, res, 1, prec);
+    acb_mul_2exp_si(res, res, -1);
+}
+
+Acb Acb::norm_pdf() const & {
+    Acb ans;
+    _acb_norm_pdf(ans.t, this -> t, Precision::get());
+    return ans;
+}
+
+Acb Acb::norm_pdf() && {
+    _acb_norm_pdf(this -> t, this -> t, Precision::get());
+    return std::move(*this);
 }
 
 Acb Acb::norm_pdf(const Acb& x) {
     return x.norm_pdf();
 }
 
-Acb Acb::norm_cdf() const {
-    return (1 + ((*this)/sqrt(2)).erf())/2;
+Acb Acb::norm_pdf(Acb&& x) {
+    return std::move(x).norm_pdf();
+}
+
+Acb Acb::norm_cdf() const & {
+    Acb ans;
+    _acb_norm_cdf(ans.t, this -> t, Precision::get());
+    return ans;
+}
+
+Acb Acb::norm_cdf() && {
+    _acb_norm_cdf(this -> t, this -> t, Precision::get());
+    return std::move(*this);
 }
 
 Acb Acb::norm_cdf(const Acb& x) {
     return x.norm_cdf();
 }
+
+Acb Acb::norm_cdf(Acb&& x) {
+    return std::move(x).norm_cdf();
+}
@@ -26,6 +26,13 @@ public:
     Acb(const Arb real, const Arb imag);
 
     Acb(const acb_t z);
+
+    // copy/move -- moving just swaps the underlying acb_t
+    Acb(const Acb& z);
+    Acb(Acb&& z) noexcept;
+
+    Acb& operator=(const Acb& rhs);
+    Acb& operator=(Acb&& rhs) noexcept;
     
     // destructor
     virtual ~Acb();
@@ -34,10 +41,36 @@ public:
     void println();
 
     // internal operators
-    Acb operator+(const Acb& rhs) const;
-    Acb operator-(const Acb& rhs) const;
-    Acb operator*(const Acb& rhs) const;
-    Acb operator/(const Acb& rhs) const;
+    // as for Arb, the && overloads reuse the temporary's acb_t
+    Acb operator+(const Acb& rhs) const &;
+    Acb operator-(const Acb& rhs) const &;
+    Acb operator*(const Acb& rhs) const &;
+    Acb operator/(const Acb& rhs) const &;
+
+    Acb operator+(const Acb& rhs) &&;
+    Acb operator-(const Acb& rhs) &&;
+    Acb operator*(const Acb& rhs) &&;
+    Acb operator/(const Acb& rhs) &&;
+
+    Acb operator+(Acb&& rhs) const &;
+    Acb operator-(Acb&& rhs) const &;
+    Acb operator*(Acb&& rhs) const &;
+    Acb operator/(Acb&& rhs) const &;
+
+    Acb operator+(Acb&& rhs) &&;
+    Acb operator-(Acb&& rhs) &&;
+    Acb operator*(Acb&& rhs) &&;
+    Acb operator/(Acb&& rhs) &&;
+
+    Acb operator+(double rhs) const &;
+    Acb operator-(double rhs) const &;
+    Acb operator*(double rhs) const &;
+    Acb operator/(double rhs) const &;
+
+    Acb operator+(double rhs) &&;
+    Acb operator-(double rhs) &&;
+    Acb operator*(double rhs) &&;
+    Acb operator/(double rhs) &&;
   
     // interval arithmetic operations
     Arb real() const;
@@ -45,8 +78,10 @@ public:
 
     int is_real() const;
 
-    Acb join(const Acb& rhs) const;
+    Acb join(const Acb& rhs) const &;
+    Acb join(const Acb& rhs) &&;
     static Acb join(const Acb& lhs, const Acb& rhs);
+    static Acb join(Acb&& lhs, const Acb& rhs);
 
     static Acb nan();
     int is_nan() const;
@@ -54,37 +89,55 @@ public:
     // mathematical constants and functions
     static Acb pi();
 
-    Acb exp() const;
+    Acb exp() const &;
+    Acb exp() &&;
     static Acb exp(const Acb& x);
+    static Acb exp(Acb&& x);
 
-    Acb sqrt() const;
+    Acb sqrt() const &;
+    Acb sqrt() &&;
     static Acb sqrt(const Acb& x);
+    static Acb sqrt(Acb&& x);
 
     //useful for integration
-    Acb sqrt_analytic(int analytic) const;
+    Acb sqrt_analytic(int analytic) const &;
+    Acb sqrt_analytic(int analytic) &&;
     static Acb sqrt_analytic(const Acb& x, int analytic); 
+    static Acb sqrt_analytic(Acb&& x, int analytic);
 
     // superior to pow(2)
-    Acb sqr() const;
+    Acb sqr() const &;
+    Acb sqr() &&;
     static Acb sqr(const Acb& x);
+    static Acb sqr(Acb&& x);
 
-    Acb pow(const Acb& rhs) const;
+    Acb pow(const Acb& rhs) const &;
+    Acb pow(const Acb& rhs) &&;
     static Acb pow(const Acb& lhs, const Acb& rhs);
+    static Acb pow(Acb&& lhs, const Acb& rhs);
 
     //useful for integration
-    Acb pow_analytic(const Acb& rhs, int analytic) const;
+    Acb pow_analytic(const Acb& rhs, int analytic) const &;
+    Acb pow_analytic(const Acb& rhs, int analytic) &&;
     static Acb pow_analytic(const Acb& lhs, const Acb& rhs, int analytic);
+    static Acb pow_analytic(Acb&& lhs, const Acb& rhs, int analytic);
 
-    Acb erf() const;
+    Acb erf() const &;
+    Acb erf() &&;
     static Acb erf(const Acb& x);
+    static Acb erf(Acb&& x);
 
     // following functions are for the standard Gaussian
     // with mean 0 and variance 1
-    Acb norm_pdf() const;
+    Acb norm_pdf() const &;
+    Acb norm_pdf() &&;
     static Acb norm_pdf(const Acb& x);
+    static Acb norm_pdf(Acb&& x);
 
-    Acb norm_cdf() const;
+    Acb norm_cdf() const &;
+    Acb norm_cdf() &&;
     static Acb norm_cdf(const Acb& x);
+    static Acb norm_cdf(Acb&& x);
 
     // internal data
     acb_t t;
@@ -98,10 +151,28 @@ Acb operator-(double lhs, const Acb& rhs);
 Acb operator*(double lhs, const Acb& rhs);
 Acb operator/(double lhs, const Acb& rhs);
 
+Acb operator+(double lhs, Acb&& rhs);
+Acb operator-(double lhs, Acb&& rhs);
+Acb operator*(double lhs, Acb&& rhs);
+Acb operator/(double lhs, Acb&& rhs);
+
 // same with Arb on lhs
 Acb operator+(const Arb& lhs, const Acb& rhs);
 Acb operator-(const Arb& lhs, const Acb& rhs);
 Acb operator*(const Arb& lhs, const Acb& rhs);
 Acb operator/(const Arb& lhs, const Acb& rhs);
 
+Acb operator+(const Arb& lhs, Acb&& rhs);
+Acb operator-(const Arb& lhs, Acb&& rhs);
+Acb operator*(const Arb& lhs, Acb&& rhs);
+Acb operator/(const Arb& lhs, Acb&& rhs);
+
+// kernels for arithmetic with a double, see _arb_add_d
+void _acb_add_d(acb_t res, const acb_t x, double d, slong prec);
+void _acb_sub_d(acb_t res, const acb_t x, double d, slong prec);
+void _acb_mul_d(acb_t res, const acb_t x, double d, slong prec);
+void _acb_div_d(acb_t res, const acb_t x, double d, slong prec);
+void _acb_d_sub(acb_t res, double d, const acb_t x, slong prec);
+void _acb_d_div(acb_t res, double d, const acb_t x, slong prec);
+
 #endif
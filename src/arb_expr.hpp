@@ -0,0 +1,322 @@
+/*
+  Copyright (c) 2022-23 Joshua Brakensiek, Neng Huang, Aaron Potechin and Uri Zwick
+
+  This code is licensed under the MIT License.
+*/
+
+#ifndef ARB_EXPR_HPP
+#define ARB_EXPR_HPP
+
+#include "arb_wrapper.hpp"
+#include <type_traits>
+
+// Expression templates over Arb.
+//
+// Wrapping one operand in lazy() makes the rest of the expression build
+// a tree instead of evaluating operator by operator. The tree is lowered
+// when it is converted to an Arb:
+//   a + b*c, a - b*c    -> arb_addmul / arb_submul (one rounding)
+//   x * 2^k, x / 2^k    -> arb_mul_2exp_si (exact)
+//   x * n, x / n        -> arb_mul_si / arb_div_si for small integers n
+//   x + d, x * d, ...   -> the _arb_*_d kernels (no temporary Arb)
+//   x * x               -> arb_sqr (tighter when x contains 0)
+// e.g.
+//   Arb t1 = (1 + lazy(beta)*b1)/2;
+//   Arb q = t1.sqr() + t2.sqr() - 2*lazy(rho)*t1*t2;
+//
+// Leaves are held by reference, so an expression must be converted to
+// an Arb in the same statement it is built in (never store it in auto).
+
+template <class D>
+class ArbExpr {
+public:
+    const D& self() const { return static_cast<const D&>(*this); }
+
+    operator Arb() const {
+        Arb ans;
+        self().eval(ans.t, Precision::get());
+        return ans;
+    }
+};
+
+// leaves
+
+class ArbExprRef : public ArbExpr<ArbExprRef> {
+public:
+    explicit ArbExprRef(const Arb& x) : x(x) { }
+    void eval(arb_t res, slong prec) const { arb_set(res, x.t); }
+
+    const Arb& x;
+};
+
+class ArbExprScalar : public ArbExpr<ArbExprScalar> {
+public:
+    explicit ArbExprScalar(double v) : v(v) { }
+    void eval(arb_t res, slong prec) const { arb_set_d(res, v); }
+
+    double v;
+};
+
+// internal nodes
+
+template <class L, class R>
+class ArbExprAdd : public ArbExpr<ArbExprAdd<L, R>> {
+public:
+    ArbExprAdd(const L& l, const R& r) : l(l), r(r) { }
+    void eval(arb_t res, slong prec) const;
+    L l; R r;
+};
+
+template <class L, class R>
+class ArbExprSub : public ArbExpr<ArbExprSub<L, R>> {
+public:
+    ArbExprSub(const L& l, const R& r) : l(l), r(r) { }
+    void eval(arb_t res, slong prec) const;
+    L l; R r;
+};
+
+template <class L, class R>
+class ArbExprMul : public ArbExpr<ArbExprMul<L, R>> {
+public:
+    ArbExprMul(const L& l, const R& r) : l(l), r(r) { }
+    void eval(arb_t res, slong prec) const;
+    L l; R r;
+};
+
+template <class L, class R>
+class ArbExprDiv : public ArbExpr<ArbExprDiv<L, R>> {
+public:
+    ArbExprDiv(const L& l, const R& r) : l(l), r(r) { }
+    void eval(arb_t res, slong prec) const;
+    L l; R r;
+};
+
+template <class E>
+class ArbExprNeg : public ArbExpr<ArbExprNeg<E>> {
+public:
+    explicit ArbExprNeg(const E& e) : e(e) { }
+    void eval(arb_t res, slong prec) const {
+        e.eval(res, prec);
+        arb_neg(res, res);
+    }
+    E e;
+};
+
+// type traits
+
+template <class T>
+struct arb_expr_is_node : std::is_base_of<ArbExpr<T>, T> { };
+
+template <class T>
+struct arb_expr_is_mul : std::false_type { };
+template <class L, class R>
+struct arb_expr_is_mul<ArbExprMul<L, R>> : std::true_type { };
+
+template <class T>
+struct arb_expr_is_scalar : std::is_same<T, ArbExprScalar> { };
+
+// what an operand of type T becomes inside a tree
+template <class T, class = void>
+struct arb_expr_node { };
+
+template <class T>
+struct arb_expr_node<T, typename std::enable_if<arb_expr_is_node<T>::value>::type> {
+    typedef T type;
+    static const T& make(const T& x) { return x; }
+};
+
+template <>
+struct arb_expr_node<Arb> {
+    typedef ArbExprRef type;
+    static ArbExprRef make(const Arb& x) { return ArbExprRef(x); }
+};
+
+template <class T>
+struct arb_expr_node<T, typename std::enable_if<std::is_arithmetic<T>::value>::type> {
+    typedef ArbExprScalar type;
+    static ArbExprScalar make(T x) { return ArbExprScalar((double) x); }
+};
+
+template <class T>
+using arb_expr_node_t = typename arb_expr_node<typename std::decay<T>::type>::type;
+
+// an operator builds a node only if one side already is a node,
+// so plain Arb arithmetic is left alone; operands are taken as
+// forwarding references so that a temporary Arb on either side binds
+// as well here as to the rvalue overloads of Arb itself
+template <class L, class R>
+using arb_expr_enable_t = typename std::enable_if<
+    (arb_expr_is_node<typename std::decay<L>::type>::value ||
+     arb_expr_is_node<typename std::decay<R>::type>::value),
+    int>::type;
+
+template <class T>
+arb_expr_node_t<T> arb_expr_make(const T& x) {
+    return arb_expr_node<typename std::decay<T>::type>::make(x);
+}
+
+// entry point
+inline ArbExprRef lazy(const Arb& x) {
+    return ArbExprRef(x);
+}
+
+template <class L, class R, arb_expr_enable_t<L, R> = 0>
+ArbExprAdd<arb_expr_node_t<L>, arb_expr_node_t<R>> operator+(L&& l, R&& r) {
+    return ArbExprAdd<arb_expr_node_t<L>, arb_expr_node_t<R>>(arb_expr_make(l), arb_expr_make(r));
+}
+
+template <class L, class R, arb_expr_enable_t<L, R> = 0>
+ArbExprSub<arb_expr_node_t<L>, arb_expr_node_t<R>> operator-(L&& l, R&& r) {
+    return ArbExprSub<arb_expr_node_t<L>, arb_expr_node_t<R>>(arb_expr_make(l), arb_expr_make(r));
+}
+
+template <class L, class R, arb_expr_enable_t<L, R> = 0>
+ArbExprMul<arb_expr_node_t<L>, arb_expr_node_t<R>> operator*(L&& l, R&& r) {
+    return ArbExprMul<arb_expr_node_t<L>, arb_expr_node_t<R>>(arb_expr_make(l), arb_expr_make(r));
+}
+
+template <class L, class R, arb_expr_enable_t<L, R> = 0>
+ArbExprDiv<arb_expr_node_t<L>, arb_expr_node_t<R>> operator/(L&& l, R&& r) {
+    return ArbExprDiv<arb_expr_node_t<L>, arb_expr_node_t<R>>(arb_expr_make(l), arb_expr_make(r));
+}
+
+template <class E, typename std::enable_if<arb_expr_is_node<E>::value, int>::type = 0>
+ArbExprNeg<E> operator-(const E& e) {
+    return ArbExprNeg<E>(e);
+}
+
+// lowering
+
+// an evaluated operand: leaves are used in place,
+// anything else is evaluated once into a temporary
+template <class E>
+class ArbExprOperand {
+public:
+    ArbExprOperand(const E& e, slong prec) { e.eval(tmp.t, prec); }
+    arb_srcptr ptr() const { return tmp.t; }
+private:
+    Arb tmp;
+};
+
+template <>
+class ArbExprOperand<ArbExprRef> {
+public:
+    ArbExprOperand(const ArbExprRef& e, slong prec) : x(e.x) { }
+    arb_srcptr ptr() const { return x.t; }
+private:
+    const Arb& x;
+};
+
+// res += sign * a * b, squaring when a and b are the same ball
+template <class A, class B>
+void arb_expr_fma(arb_t res, const A& a, const B& b, int sign, slong prec) {
+    ArbExprOperand<A> x(a, prec);
+    ArbExprOperand<B> y(b, prec);
+    if (x.ptr() == y.ptr()) {
+        Arb sq;
+        arb_sqr(sq.t, x.ptr(), prec);
+        if (sign > 0) {
+            arb_add(res, res, sq.t, prec);
+        }
+        else {
+            arb_sub(res, res, sq.t, prec);
+        }
+    }
+    else if (sign > 0) {
+        arb_addmul(res, x.ptr(), y.ptr(), prec);
+    }
+    else {
+        arb_submul(res, x.ptr(), y.ptr(), prec);
+    }
+}
+
+template <class L, class R>
+void ArbExprAdd<L, R>::eval(arb_t res, slong prec) const {
+    if constexpr (arb_expr_is_mul<R>::value) {
+        l.eval(res, prec);
+        arb_expr_fma(res, r.l, r.r, 1, prec);
+    }
+    else if constexpr (arb_expr_is_mul<L>::value) {
+        r.eval(res, prec);
+        arb_expr_fma(res, l.l, l.r, 1, prec);
+    }
+    else if constexpr (arb_expr_is_scalar<R>::value) {
+        l.eval(res, prec);
+        _arb_add_d(res, res, r.v, prec);
+    }
+    else if constexpr (arb_expr_is_scalar<L>::value) {
+        ArbExprAdd<R, L>(r, l).eval(res, prec);
+    }
+    else {
+        ArbExprOperand<L> x(l, prec);
+        ArbExprOperand<R> y(r, prec);
+        arb_add(res, x.ptr(), y.ptr(), prec);
+    }
+}
+
+template <class L, class R>
+void ArbExprSub<L, R>::eval(arb_t res, slong prec) const {
+    if constexpr (arb_expr_is_mul<R>::value) {
+        l.eval(res, prec);
+        arb_expr_fma(res, r.l, r.r, -1, prec);
+    }
+    else if constexpr (arb_expr_is_mul<L>::value) {
+        r.eval(res, prec);
+        arb_neg(res, res);
+        arb_expr_fma(res, l.l, l.r, 1, prec);
+    }
+    else if constexpr (arb_expr_is_scalar<R>::value) {
+        l.eval(res, prec);
+        _arb_sub_d(res, res, r.v, prec);
+    }
+    else if constexpr (arb_expr_is_scalar<L>::value) {
+        r.eval(res, prec);
+        _arb_d_sub(res, l.v, res, prec);
+    }
+    else {
+        ArbExprOperand<L> x(l, prec);
+        ArbExprOperand<R> y(r, prec);
+        arb_sub(res, x.ptr(), y.ptr(), prec);
+    }
+}
+
+template <class L, class R>
+void ArbExprMul<L, R>::eval(arb_t res, slong prec) const {
+    if constexpr (arb_expr_is_scalar<R>::value) {
+        l.eval(res, prec);
+        _arb_mul_d(res, res, r.v, prec);
+    }
+    else if constexpr (arb_expr_is_scalar<L>::value) {
+        r.eval(res, prec);
+        _arb_mul_d(res, res, l.v, prec);
+    }
+    else {
+        ArbExprOperand<L> x(l, prec);
+        ArbExprOperand<R> y(r, prec);
+        if (x.ptr() == y.ptr()) {
+            arb_sqr(res, x.ptr(), prec);
+        }
+        else {
+            arb_mul(res, x.ptr(), y.ptr(), prec);
+        }
+    }
+}
+
+template <class L, class R>
+void ArbExprDiv<L, R>::eval(arb_t res, slong prec) const {
+    if constexpr (arb_expr_is_scalar<R>::value) {
+        l.eval(res, prec);
+        _arb_div_d(res, res, r.v, prec);
+    }
+    else if constexpr (arb_expr_is_scalar<L>::value) {
+        r.eval(res, prec);
+        _arb_d_div(res, l.v, res, prec);
+    }
+    else {
+        ArbExprOperand<L> x(l, prec);
+        ArbExprOperand<R> y(r, prec);
+        arb_div(res, x.ptr(), y.ptr(), prec);
+    }
+}
+
+#endif
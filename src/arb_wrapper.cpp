@@ -7,6 +7,9 @@
 #include "arb_wrapper.hpp"
 #include "arb_hypgeom.h"
 #include <cassert>
+#include <cmath>
+#include <deque>
+#include <utility>
 
 // constructors
 
@@ -22,7 +25,27 @@ Arb::Arb(double d) {
 Arb::Arb(double d1, double d2) {
     arb_init(this -> t);
     Arb x(d1), y(d2);
-    arb_union(this -> t, x.t, y.t, GLOBAL_PRECISION);
+    arb_union(this -> t, x.t, y.t, Precision::get());
+}
+
+Arb::Arb(const Arb& x) {
+    arb_init(this -> t);
+    arb_set(this -> t, x.t);
+}
+
+Arb::Arb(Arb&& x) noexcept {
+    arb_init(this -> t);
+    arb_swap(this -> t, x.t);
+}
+
+Arb& Arb::operator=(const Arb& rhs) {
+    arb_set(this -> t, rhs.t);
+    return *this;
+}
+
+Arb& Arb::operator=(Arb&& rhs) noexcept {
+    arb_swap(this -> t, rhs.t);
+    return *this;
 }
 
 // destructor
@@ -57,19 +80,28 @@ void Arb::pretty_println() const {
 
 
 // interval arithmetic operations
-Arb Arb::join(const Arb& rhs) const {
+Arb Arb::join(const Arb& rhs) const & {
     Arb ans;
-    arb_union(ans.t, this->t, rhs.t, GLOBAL_PRECISION);
+    arb_union(ans.t, this->t, rhs.t, Precision::get());
     return ans;
 }
 
+Arb Arb::join(const Arb& rhs) && {
+    arb_union(this->t, this->t, rhs.t, Precision::get());
+    return std::move(*this);
+}
+
 Arb Arb::join(const Arb& lhs, const Arb& rhs) {
     return lhs.join(rhs);
 }
 
+Arb Arb::join(Arb&& lhs, const Arb& rhs) {
+    return std::move(lhs).join(rhs);
+}
+
 Arb Arb::intersect(const Arb& rhs) const {
     Arb ans;
-    if (arb_intersection(ans.t, this->t, rhs.t, GLOBAL_PRECISION)) {
+    if (arb_intersection(ans.t, this->t, rhs.t, Precision::get())) {
         return ans;
     }
     else {
@@ -110,23 +142,76 @@ Arb Arb::rad() const {
 }
 
 Arb Arb::left_edge() const {
-    Arb m = this->mid();
-    Arb r = this->rad();
-    return m-r;
+    Arb ans;
+    arb_get_lbound_arf(arb_midref(ans.t), this->t, ARF_PREC_EXACT);
+    return ans;
 }
 
 Arb Arb::right_edge() const {
-    Arb m = this->mid();
-    Arb r = this->rad();
-    return m+r;
+    Arb ans;
+    arb_get_ubound_arf(arb_midref(ans.t), this->t, ARF_PREC_EXACT);
+    return ans;
+}
+
+// ball of radius rad/2 centered at mid + sign*rad/2; res may alias x
+static void _arb_half(arb_t res, const arb_t x, int sign) {
+    arf_t r;
+    arf_init(r);
+    arf_set_mag(r, arb_radref(x));
+    arf_mul_2exp_si(r, r, -1);
+    if (sign > 0) {
+        arf_add(arb_midref(res), arb_midref(x), r, ARF_PREC_EXACT, ARF_RND_DOWN);
+    }
+    else {
+        arf_sub(arb_midref(res), arb_midref(x), r, ARF_PREC_EXACT, ARF_RND_DOWN);
+    }
+    mag_mul_2exp_si(arb_radref(res), arb_radref(x), -1);
+    arf_clear(r);
 }
 
 Arb Arb::left_half() const {
-    return join(this->left_edge(), this->mid());
+    Arb ans;
+    if (!arb_is_finite(this->t)) {
+        arb_set(ans.t, this->t);
+    }
+    else {
+        _arb_half(ans.t, this->t, -1);
+    }
+    return ans;
 }
 
 Arb Arb::right_half() const {
-    return join(this->mid(), this->right_edge());
+    Arb ans;
+    if (!arb_is_finite(this->t)) {
+        arb_set(ans.t, this->t);
+    }
+    else {
+        _arb_half(ans.t, this->t, 1);
+    }
+    return ans;
+}
+
+std::pair<Arb, Arb> Arb::split() const {
+    return std::make_pair(this->left_half(), this->right_half());
+}
+
+Arb Arb::dyadic_piece(slong level, ulong index) const {
+    assert(0 <= level && level <= 62 && index < (UWORD(1) << level));
+    Arb ans;
+    if (!arb_is_finite(this->t)) {
+        arb_set(ans.t, this->t);
+        return ans;
+    }
+    // mid + rad * (2 index + 1 - 2^level) / 2^level
+    arf_t r;
+    arf_init(r);
+    arf_set_mag(r, arb_radref(this->t));
+    arf_mul_si(r, r, 2 * (slong) index + 1 - (WORD(1) << level), ARF_PREC_EXACT, ARF_RND_DOWN);
+    arf_mul_2exp_si(r, r, -level);
+    arf_add(arb_midref(ans.t), arb_midref(this->t), r, ARF_PREC_EXACT, ARF_RND_DOWN);
+    mag_mul_2exp_si(arb_radref(ans.t), arb_radref(this->t), -level);
+    arf_clear(r);
+    return ans;
 }
 
 Arb Arb::nan() {
@@ -141,78 +226,295 @@ int Arb::is_nan() const {
 
 // operators
 
-Arb Arb::operator-() const {
+Arb Arb::operator-() const & {
     Arb ans;
     arb_neg(ans.t, this->t);
     return ans;
 }
 
+Arb Arb::operator-() && {
+    arb_neg(this->t, this->t);
+    return std::move(*this);
+}
 
-Arb Arb::operator+(const Arb& rhs) const {
+Arb Arb::operator+(const Arb& rhs) const & {
     Arb ans;
-    arb_add(ans.t, this->t, rhs.t, GLOBAL_PRECISION);
+    arb_add(ans.t, this->t, rhs.t, Precision::get());
     return ans;
 }
 
-Arb Arb::operator-(const Arb& rhs) const {
+Arb Arb::operator-(const Arb& rhs) const & {
     Arb ans;
-    arb_sub(ans.t, this->t, rhs.t, GLOBAL_PRECISION);
+    arb_sub(ans.t, this->t, rhs.t, Precision::get());
     return ans;
 }
 
-Arb Arb::operator*(const Arb& rhs) const {
+Arb Arb::operator*(const Arb& rhs) const & {
     Arb ans;
-    arb_mul(ans.t, this->t, rhs.t, GLOBAL_PRECISION);
+    arb_mul(ans.t, this->t, rhs.t, Precision::get());
     return ans;
 }
 
-Arb Arb::operator/(const Arb& rhs) const {
+Arb Arb::operator/(const Arb& rhs) const & {
     Arb ans;
-    arb_div(ans.t, this->t, rhs.t, GLOBAL_PRECISION);
+    arb_div(ans.t, this->t, rhs.t, Precision::get());
     return ans;
 }
 
-Arb Arb::operator+(double rhs) const {
-    Arb x(rhs);
-    return (*this) + x;
+// arb allows the output to alias either input, so the
+// temporaries below are simply overwritten in place
+
+Arb Arb::operator+(const Arb& rhs) && {
+    arb_add(this->t, this->t, rhs.t, Precision::get());
+    return std::move(*this);
+}
+
+Arb Arb::operator-(const Arb& rhs) && {
+    arb_sub(this->t, this->t, rhs.t, Precision::get());
+    return std::move(*this);
+}
+
+Arb Arb::operator*(const Arb& rhs) && {
+    arb_mul(this->t, this->t, rhs.t, Precision::get());
+    return std::move(*this);
+}
+
+Arb Arb::operator/(const Arb& rhs) && {
+    arb_div(this->t, this->t, rhs.t, Precision::get());
+    return std::move(*this);
+}
+
+Arb Arb::operator+(Arb&& rhs) const & {
+    arb_add(rhs.t, this->t, rhs.t, Precision::get());
+    return std::move(rhs);
+}
+
+Arb Arb::operator-(Arb&& rhs) const & {
+    arb_sub(rhs.t, this->t, rhs.t, Precision::get());
+    return std::move(rhs);
+}
+
+Arb Arb::operator*(Arb&& rhs) const & {
+    arb_mul(rhs.t, this->t, rhs.t, Precision::get());
+    return std::move(rhs);
+}
+
+Arb Arb::operator/(Arb&& rhs) const & {
+    arb_div(rhs.t, this->t, rhs.t, Precision::get());
+    return std::move(rhs);
+}
+
+Arb Arb::operator+(Arb&& rhs) && {
+    return std::move(*this) + static_cast<const Arb&>(rhs);
 }
 
-Arb Arb::operator-(double rhs) const {
-    Arb x(rhs);
-    return (*this) - x;
+Arb Arb::operator-(Arb&& rhs) && {
+    return std::move(*this) - static_cast<const Arb&>(rhs);
 }
 
-Arb Arb::operator*(double rhs) const {
-    Arb x(rhs);
-    return (*this) * x;
+Arb Arb::operator*(Arb&& rhs) && {
+    return std::move(*this) * static_cast<const Arb&>(rhs);
 }
 
-Arb Arb::operator/(double rhs) const {
-    Arb x(rhs);
-    return (*this) / x;
+Arb Arb::operator/(Arb&& rhs) && {
+    return std::move(*this) / static_cast<const Arb&>(rhs);
+}
+
+Arb Arb::operator+(double rhs) const & {
+    Arb ans;
+    _arb_add_d(ans.t, this->t, rhs, Precision::get());
+    return ans;
+}
+
+Arb Arb::operator-(double rhs) const & {
+    Arb ans;
+    _arb_sub_d(ans.t, this->t, rhs, Precision::get());
+    return ans;
+}
+
+Arb Arb::operator*(double rhs) const & {
+    Arb ans;
+    _arb_mul_d(ans.t, this->t, rhs, Precision::get());
+    return ans;
+}
+
+Arb Arb::operator/(double rhs) const & {
+    Arb ans;
+    _arb_div_d(ans.t, this->t, rhs, Precision::get());
+    return ans;
+}
+
+Arb Arb::operator+(double rhs) && {
+    _arb_add_d(this->t, this->t, rhs, Precision::get());
+    return std::move(*this);
+}
+
+Arb Arb::operator-(double rhs) && {
+    _arb_sub_d(this->t, this->t, rhs, Precision::get());
+    return std::move(*this);
+}
+
+Arb Arb::operator*(double rhs) && {
+    _arb_mul_d(this->t, this->t, rhs, Precision::get());
+    return std::move(*this);
+}
+
+Arb Arb::operator/(double rhs) && {
+    _arb_div_d(this->t, this->t, rhs, Precision::get());
+    return std::move(*this);
 }
 
 
 Arb operator+(double lhs, const Arb& rhs) {
-    Arb x(lhs);
-    return x + rhs;
+    return rhs + lhs;
 }
 
 Arb operator-(double lhs, const Arb& rhs) {
-    Arb x(lhs);
-    return x - rhs;
+    Arb ans;
+    _arb_d_sub(ans.t, lhs, rhs.t, Precision::get());
+    return ans;
 }
 
 Arb operator*(double lhs, const Arb& rhs) {
-    Arb x(lhs);
-    return x * rhs;
+    return rhs * lhs;
 }
 
 Arb operator/(double lhs, const Arb& rhs) {
-    Arb x(lhs);
-    return x / rhs;
+    Arb ans;
+    _arb_d_div(ans.t, lhs, rhs.t, Precision::get());
+    return ans;
+}
+
+Arb operator+(double lhs, Arb&& rhs) {
+    return std::move(rhs) + lhs;
+}
+
+Arb operator-(double lhs, Arb&& rhs) {
+    _arb_d_sub(rhs.t, lhs, rhs.t, Precision::get());
+    return std::move(rhs);
+}
+
+Arb operator*(double lhs, Arb&& rhs) {
+    return std::move(rhs) * lhs;
 }
 
+Arb operator/(double lhs, Arb&& rhs) {
+    _arb_d_div(rhs.t, lhs, rhs.t, Precision::get());
+    return std::move(rhs);
+}
+
+// scalar kernels
+
+int _d_is_si(double d, slong& n) {
+    // 2^52: every double below this that equals its truncation fits
+    if (!(std::fabs(d) < 4503599627370496.0) || d != std::trunc(d)) {
+        return 0;
+    }
+    n = (slong) d;
+    return 1;
+}
+
+int _d_is_pow2(double d, slong& e) {
+    int k;
+    if (d == 0 || !std::isfinite(d) || std::frexp(std::fabs(d), &k) != 0.5) {
+        return 0;
+    }
+    e = k - 1;
+    return 1;
+}
+
+void _arb_add_d(arb_t res, const arb_t x, double d, slong prec) {
+    slong n;
+    if (_d_is_si(d, n)) {
+        arb_add_si(res, x, n, prec);
+    }
+    else {
+        arf_t y;
+        arf_init(y);
+        arf_set_d(y, d);
+        arb_add_arf(res, x, y, prec);
+        arf_clear(y);
+    }
+}
+
+void _arb_sub_d(arb_t res, const arb_t x, double d, slong prec) {
+    slong n;
+    if (_d_is_si(d, n)) {
+        arb_sub_si(res, x, n, prec);
+    }
+    else {
+        arf_t y;
+        arf_init(y);
+        arf_set_d(y, d);
+        arb_sub_arf(res, x, y, prec);
+        arf_clear(y);
+    }
+}
+
+void _arb_mul_d(arb_t res, const arb_t x, double d, slong prec) {
+    slong n;
+    if (_d_is_pow2(d, n)) {
+        arb_mul_2exp_si(res, x, n);
+        if (d < 0) {
+            arb_neg(res, res);
+        }
+    }
+    else if (_d_is_si(d, n)) {
+        arb_mul_si(res, x, n, prec);
+    }
+    else {
+        arf_t y;
+        arf_init(y);
+        arf_set_d(y, d);
+        arb_mul_arf(res, x, y, prec);
+        arf_clear(y);
+    }
+}
+
+void _arb_div_d(arb_t res, const arb_t x, double d, slong prec) {
+    slong n;
+    if (_d_is_pow2(d, n)) {
+        arb_mul_2exp_si(res, x, -n);
+        if (d < 0) {
+            arb_neg(res, res);
+        }
+    }
+    else if (d != 0 && _d_is_si(d, n)) {
+        arb_div_si(res, x, n, prec);
+    }
+    else {
+        arf_t y;
+        arf_init(y);
+        arf_set_d(y, d);
+        arb_div_arf(res, x, y, prec);
+        arf_clear(y);
+    }
+}
+
+void _arb_d_sub(arb_t res, double d, const arb_t x, slong prec) {
+    // d - x = -(x - d), and negation is exact
+    _arb_sub_d(res, x, d, prec);
+    arb_neg(res, res);
+}
+
+void _arb_d_div(arb_t res, double d, const arb_t x, slong prec) {
+    slong n;
+    if (_d_is_pow2(d, n)) {
+        arb_inv(res, x, prec);
+        arb_mul_2exp_si(res, res, n);
+        if (d < 0) {
+            arb_neg(res, res);
+        }
+    }
+    else {
+        // a bare arb_t on the stack; a double never needs heap limbs
+        arb_t y;
+        arb_init(y);
+        arb_set_d(y, d);
+        arb_div(res, y, x, prec);
+        arb_clear(y);
+    }
+}
 
 
 int Arb::operator==(const Arb& rhs) const {
@@ -241,64 +543,182 @@ int Arb::operator>=(const Arb& rhs) const {
 
 // mathematical constants and functions
 
-Arb Arb::pi() {
+// constant cache
+
+class _ArbConstTable {
+public:
+    explicit _ArbConstTable(slong prec) : prec(prec) {
+        for (int i = 0; i < ARB_NUM_CONSTS; i++) {
+            arb_init(c + i);
+        }
+        arb_const_pi(c + ARB_CONST_PI, prec);
+        arb_sqrt_ui(c + ARB_CONST_SQRT2, 2, prec);
+        arb_rsqrt_ui(c + ARB_CONST_INV_SQRT2, 2, prec);
+        arb_t two_pi;
+        arb_init(two_pi);
+        arb_mul_2exp_si(two_pi, c + ARB_CONST_PI, 1);
+        arb_rsqrt(c + ARB_CONST_INV_SQRT_2PI, two_pi, prec);
+        arb_log(c + ARB_CONST_LOG_2PI, two_pi, prec);
+        arb_clear(two_pi);
+    }
+
+    ~_ArbConstTable() {
+        for (int i = 0; i < ARB_NUM_CONSTS; i++) {
+            arb_clear(c + i);
+        }
+    }
+
+    _ArbConstTable(const _ArbConstTable&) = delete;
+    _ArbConstTable& operator=(const _ArbConstTable&) = delete;
+
+    slong prec;
+    arb_struct c[ARB_NUM_CONSTS];
+};
+
+// one table per precision used by the thread; a deque never moves its
+// elements, so pointers into it stay valid
+static thread_local std::deque<_ArbConstTable> const_tables;
+static thread_local _ArbConstTable* const_last = NULL;
+
+arb_srcptr _arb_const(ArbConst c, slong prec) {
+    if (const_last == NULL || const_last->prec != prec) {
+        const_last = NULL;
+        for (_ArbConstTable& table : const_tables) {
+            if (table.prec == prec) {
+                const_last = &table;
+                break;
+            }
+        }
+        if (const_last == NULL) {
+            const_last = &const_tables.emplace_back(prec);
+        }
+    }
+    return const_last->c + c;
+}
+
+static Arb _arb_const_copy(ArbConst c) {
     Arb ans;
-    arb_const_pi(ans.t, GLOBAL_PRECISION);
+    arb_set(ans.t, _arb_const(c, Precision::get()));
     return ans;
 }
 
-Arb Arb::abs() const {
+Arb Arb::pi() {
+    return _arb_const_copy(ARB_CONST_PI);
+}
+
+Arb Arb::sqrt2() {
+    return _arb_const_copy(ARB_CONST_SQRT2);
+}
+
+Arb Arb::inv_sqrt2() {
+    return _arb_const_copy(ARB_CONST_INV_SQRT2);
+}
+
+Arb Arb::inv_sqrt_2pi() {
+    return _arb_const_copy(ARB_CONST_INV_SQRT_2PI);
+}
+
+Arb Arb::log_2pi() {
+    return _arb_const_copy(ARB_CONST_LOG_2PI);
+}
+
+Arb Arb::abs() const & {
     Arb ans;
     arb_abs(ans.t, this->t);
     return ans;
 }
 
+Arb Arb::abs() && {
+    arb_abs(this->t, this->t);
+    return std::move(*this);
+}
+
 Arb Arb::abs(const Arb& x) {
     return x.abs();
 }
 
-Arb Arb::min(const Arb& rhs) const {
+Arb Arb::abs(Arb&& x) {
+    return std::move(x).abs();
+}
+
+Arb Arb::min(const Arb& rhs) const & {
     Arb ans;
-    arb_min(ans.t, this -> t, rhs.t, GLOBAL_PRECISION);
+    arb_min(ans.t, this -> t, rhs.t, Precision::get());
     return ans;
 }
 
+Arb Arb::min(const Arb& rhs) && {
+    arb_min(this -> t, this -> t, rhs.t, Precision::get());
+    return std::move(*this);
+}
+
 Arb Arb::min(const Arb& lhs, const Arb& rhs) {
     return lhs.min(rhs);
 }
 
-Arb Arb::max(const Arb& rhs) const {
+Arb Arb::min(Arb&& lhs, const Arb& rhs) {
+    return std::move(lhs).min(rhs);
+}
+
+Arb Arb::max(const Arb& rhs) const & {
     Arb ans;
-    arb_max(ans.t, this -> t, rhs.t, GLOBAL_PRECISION);
+    arb_max(ans.t, this -> t, rhs.t, Precision::get());
     return ans;
 }
 
+Arb Arb::max(const Arb& rhs) && {
+    arb_max(this -> t, this -> t, rhs.t, Precision::get());
+    return std::move(*this);
+}
+
 Arb Arb::max(const Arb& lhs, const Arb& rhs) {
     return lhs.max(rhs);
 }
 
+Arb Arb::max(Arb&& lhs, const Arb& rhs) {
+    return std::move(lhs).max(rhs);
+}
+
 
-Arb Arb::exp() const {
+Arb Arb::exp() const & {
     Arb ans;
-    arb_exp(ans.t, this -> t, GLOBAL_PRECISION);
+    arb_exp(ans.t, this -> t, Precision::get());
     return ans;
 }
 
+Arb Arb::exp() && {
+    arb_exp(this -> t, this -> t, Precision::get());
+    return std::move(*this);
+}
+
 Arb Arb::exp(const Arb& x) {
     return x.exp();
 }
 
-Arb Arb::sqrt() const {
+Arb Arb::exp(Arb&& x) {
+    return std::move(x).exp();
+}
+
+Arb Arb::sqrt() const & {
     Arb ans;
-    arb_sqrt(ans.t, this -> t, GLOBAL_PRECISION);
+    arb_sqrt(ans.t, this -> t, Precision::get());
     return ans;
 }
 
+Arb Arb::sqrt() && {
+    arb_sqrt(this -> t, this -> t, Precision::get());
+    return std::move(*this);
+}
+
 Arb Arb::sqrt(const Arb& x) {
     return x.sqrt();
 }
 
-Arb Arb::safe_sqrt() const {
+Arb Arb::sqrt(Arb&& x) {
+    return std::move(x).sqrt();
+}
+
+Arb Arb::safe_sqrt() const & {
     if (*this >= 0) {
         return this -> sqrt();
     }
@@ -310,70 +730,482 @@ Arb Arb::safe_sqrt() const {
     }
 }
 
+Arb Arb::safe_sqrt() && {
+    if (*this >= 0) {
+        return std::move(*this).sqrt();
+    }
+    return static_cast<const Arb&>(*this).safe_sqrt();
+}
+
 Arb Arb::safe_sqrt(const Arb& x) {
     return x.safe_sqrt();
 }
 
-Arb Arb::sqr() const {
+Arb Arb::safe_sqrt(Arb&& x) {
+    return std::move(x).safe_sqrt();
+}
+
+Arb Arb::sqr() const & {
     Arb ans;
-    arb_sqr(ans.t, this -> t, GLOBAL_PRECISION);
+    arb_sqr(ans.t, this -> t, Precision::get());
     return ans;
 }
 
+Arb Arb::sqr() && {
+    arb_sqr(this -> t, this -> t, Precision::get());
+    return std::move(*this);
+}
+
 Arb Arb::sqr(const Arb& x) {
     return x.sqr();
 }
 
-Arb Arb::pow(const Arb& rhs) const {
+Arb Arb::sqr(Arb&& x) {
+    return std::move(x).sqr();
+}
+
+Arb Arb::atan() const & {
+    Arb ans;
+    arb_atan(ans.t, this -> t, Precision::get());
+    return ans;
+}
+
+Arb Arb::atan() && {
+    arb_atan(this -> t, this -> t, Precision::get());
+    return std::move(*this);
+}
+
+Arb Arb::atan(const Arb& x) {
+    return x.atan();
+}
+
+Arb Arb::atan(Arb&& x) {
+    return std::move(x).atan();
+}
+
+Arb Arb::asin() const & {
+    Arb ans;
+    arb_asin(ans.t, this -> t, Precision::get());
+    return ans;
+}
+
+Arb Arb::asin() && {
+    arb_asin(this -> t, this -> t, Precision::get());
+    return std::move(*this);
+}
+
+Arb Arb::asin(const Arb& x) {
+    return x.asin();
+}
+
+Arb Arb::asin(Arb&& x) {
+    return std::move(x).asin();
+}
+
+Arb Arb::pow(const Arb& rhs) const & {
     Arb ans;
-    arb_pow(ans.t, this -> t, rhs.t, GLOBAL_PRECISION);
+    arb_pow(ans.t, this -> t, rhs.t, Precision::get());
     return ans;
 }
 
+Arb Arb::pow(const Arb& rhs) && {
+    arb_pow(this -> t, this -> t, rhs.t, Precision::get());
+    return std::move(*this);
+}
+
 Arb Arb::pow(const Arb& lhs, const Arb& rhs) {
     return lhs.pow(rhs);
 }
 
-Arb Arb::erf() const {
+Arb Arb::pow(Arb&& lhs, const Arb& rhs) {
+    return std::move(lhs).pow(rhs);
+}
+
+// monotone functions
+
+static slong monotone_exp = -16;
+
+slong Arb::monotone_threshold() {
+    return monotone_exp;
+}
+
+void Arb::set_monotone_threshold(slong e) {
+    monotone_exp = e;
+}
+
+typedef void (*_arb_func)(arb_t res, const arb_t x, slong prec);
+
+// res = f(x) for an increasing or decreasing f; res may alias x
+static void _arb_monotone(arb_t res, const arb_t x, _arb_func f, slong prec) {
+    if (!arb_is_finite(x) || mag_cmp_2exp_si(arb_radref(x), monotone_exp) <= 0) {
+        f(res, x, prec);
+        return;
+    }
+
+    arf_t lo, hi;
+    arf_init(lo);
+    arf_init(hi);
+    arb_get_lbound_arf(lo, x, prec);
+    arb_get_ubound_arf(hi, x, prec);
+
+    arb_t a, b;
+    arb_init(a);
+    arb_init(b);
+    arb_set_arf(a, lo);
+    arb_set_arf(b, hi);
+    f(a, a, prec);
+    f(b, b, prec);
+    arb_union(res, a, b, prec);
+
+    arb_clear(a);
+    arb_clear(b);
+    arf_clear(lo);
+    arf_clear(hi);
+}
+
+// 1 - Phi(x) = erfc(x/sqrt(2))/2
+static void _arb_norm_sf(arb_t res, const arb_t x, slong prec) {
+    arb_mul(res, x, _arb_const(ARB_CONST_INV_SQRT2, prec), prec);
+    arb_hypgeom_erfc(res, res, prec);
+    arb_mul_2exp_si(res, res, -1);
+}
+
+// Phi(x) = erfc(-x/sqrt(2))/2, which keeps full relative accuracy in the
+// lower tail; for positive x it is computed as 1 - (1 - Phi(x)), so erfc
+// only ever sees the tail it evaluates well
+static void _arb_norm_cdf(arb_t res, const arb_t x, slong prec) {
+    if (arb_is_positive(x)) {
+        _arb_norm_sf(res, x, prec);
+        arb_sub_si(res, res, 1, prec);
+        arb_neg(res, res);
+    }
+    else {
+        arb_neg(res, x);
+        _arb_norm_sf(res, res, prec);
+    }
+}
+
+// log Phi(x), via log1p(-(1 - Phi(x))) for positive x
+static void _arb_log_norm_cdf(arb_t res, const arb_t x, slong prec) {
+    if (arb_is_positive(x)) {
+        _arb_norm_sf(res, x, prec);
+        arb_neg(res, res);
+        arb_log1p(res, res, prec);
+    }
+    else {
+        _arb_norm_cdf(res, x, prec);
+        arb_log(res, res, prec);
+    }
+}
+
+// (1 - Phi(x)) / phi(x) = (1 - Phi(x)) * sqrt(2*pi) * exp(x^2/2)
+static void _arb_mills_ratio(arb_t res, const arb_t x, slong prec) {
+    arb_t e;
+    arb_init(e);
+    arb_sqr(e, x, prec);
+    arb_mul_2exp_si(e, e, -1);
+    arb_exp(e, e, prec);
+    _arb_norm_sf(res, x, prec);
+    arb_mul(res, res, e, prec);
+    arb_div(res, res, _arb_const(ARB_CONST_INV_SQRT_2PI, prec), prec);
+    arb_clear(e);
+}
+
+// sqrt(2) * erf_inv(2x - 1)
+static void _arb_norm_cdf_inv_erf(arb_t res, const arb_t x, slong prec) {
+    arb_mul_2exp_si(res, x, 1);
+    arb_sub_si(res, res, 1, prec);
+    arb_hypgeom_erfinv(res, res, prec);
+    arb_mul(res, res, _arb_const(ARB_CONST_SQRT2, prec), prec);
+}
+
+// exp(-x^2/2) / sqrt(2*pi)
+static void _arb_norm_pdf(arb_t res, const arb_t x, slong prec) {
+    arb_sqr(res, x, prec);
+    arb_mul_2exp_si(res, res, -1);
+    arb_neg(res, res);
+    arb_exp(res, res, prec);
+    arb_mul(res, res, _arb_const(ARB_CONST_INV_SQRT_2PI, prec), prec);
+}
+
+// Acklam's rational approximation to Phi^{-1}(p), 0 < p < 1
+// relative error below 1.2e-9
+static double _norm_cdf_inv_seed(double p) {
+    static const double a[6] = {-3.969683028665376e+01, 2.209460984245205e+02,
+                                -2.759285104469687e+02, 1.383577518672690e+02,
+                                -3.066479806614716e+01, 2.506628277459239e+00};
+    static const double b[5] = {-5.447609879822406e+01, 1.615858368580409e+02,
+                                -1.556989798598866e+02, 6.680131188771972e+01,
+                                -1.328068155288572e+01};
+    static const double c[6] = {-7.784894002430293e-03, -3.223964580411365e-01,
+                                -2.400758277161838e+00, -2.549732539343734e+00,
+                                4.374664141464968e+00, 2.938163982698783e+00};
+    static const double d[4] = {7.784695709041462e-03, 3.224671290700398e-01,
+                                2.445134137142996e+00, 3.754408661907416e+00};
+
+    if (p > 0.5) {
+        // 1 - p is exact here
+        return -_norm_cdf_inv_seed(1 - p);
+    }
+
+    if (p < 0.02425) {
+        double q = std::sqrt(-2 * std::log(p));
+        return (((((c[0]*q + c[1])*q + c[2])*q + c[3])*q + c[4])*q + c[5]) /
+            ((((d[0]*q + d[1])*q + d[2])*q + d[3])*q + 1);
+    }
+
+    double q = p - 0.5;
+    double r = q*q;
+    return (((((a[0]*r + a[1])*r + a[2])*r + a[3])*r + a[4])*r + a[5])*q /
+        (((((b[0]*r + b[1])*r + b[2])*r + b[3])*r + b[4])*r + 1);
+}
+
+// Phi^{-1}(p) by interval Newton from a double seed
+// for X around the seed and m its midpoint, if
+//   N(X) = m - (Phi(m) - p) / phi(X)
+// is contained in X then X holds the (unique) solution, and so does every
+// further iterate N(X) intersected with X
+// returns 0 if the enclosure could not be certified
+static int _arb_norm_cdf_inv_newton(arb_t res, const arb_t p, slong prec) {
+    double pd = arf_get_d(arb_midref(p), ARF_RND_NEAR);
+    if (!arb_is_finite(p) || !(pd > 0 && pd < 1)) {
+        return 0;
+    }
+
+    double x0 = _norm_cdf_inv_seed(pd);
+    // seed error, plus the spread caused by the radius of p
+    double r = 4e-9 * (std::fabs(x0) > 1 ? std::fabs(x0) : 1);
+    if (!mag_is_zero(arb_radref(p))) {
+        // 2 * rad(p) / phi(x0)
+        r += 2 * mag_get_d(arb_radref(p)) * std::exp(x0*x0/2) * 2.5066282746310002;
+    }
+    if (!std::isfinite(x0) || !std::isfinite(r)) {
+        return 0;
+    }
+
+    arb_t x, m, f, d;
+    arb_init(x);
+    arb_init(m);
+    arb_init(f);
+    arb_init(d);
+    arb_set_d(x, x0);
+    mag_set_d(arb_radref(x), r);
+
+    int ok = 1;
+    mag_t half;
+    mag_init(half);
+    for (int i = 0; i < 16; i++) {
+        arb_get_mid_arb(m, x);
+        _arb_norm_cdf(f, m, prec);
+        arb_sub(f, f, p, prec);
+        _arb_norm_pdf(d, x, prec);
+        arb_div(f, f, d, prec);
+        arb_sub(f, m, f, prec);
+
+        if (i == 0) {
+            if (!arb_contains(x, f)) {
+                ok = 0;
+                break;
+            }
+        }
+        else {
+            arb_intersection(f, f, x, prec);
+        }
+
+        // stop once an iteration no longer halves the radius
+        mag_mul_2exp_si(half, arb_radref(x), -1);
+        int progress = mag_cmp(arb_radref(f), half) < 0;
+        arb_swap(x, f);
+        if (!progress) {
+            break;
+        }
+    }
+
+    if (ok) {
+        arb_set(res, x);
+    }
+
+    mag_clear(half);
+    arb_clear(x);
+    arb_clear(m);
+    arb_clear(f);
+    arb_clear(d);
+    return ok;
+}
+
+static void _arb_norm_cdf_inv(arb_t res, const arb_t x, slong prec) {
+    if (!_arb_norm_cdf_inv_newton(res, x, prec)) {
+        _arb_norm_cdf_inv_erf(res, x, prec);
+    }
+}
+
+Arb Arb::erf() const & {
     Arb ans;
-    arb_hypgeom_erf(ans.t, this -> t, GLOBAL_PRECISION);
+    _arb_monotone(ans.t, this -> t, arb_hypgeom_erf, Precision::get());
     return ans;
 }
 
+Arb Arb::erf() && {
+    _arb_monotone(this -> t, this -> t, arb_hypgeom_erf, Precision::get());
+    return std::move(*this);
+}
+
 Arb Arb::erf(const Arb& x) {
     return x.erf();
 }
 
-Arb Arb::erf_inv() const {
+Arb Arb::erf(Arb&& x) {
+    return std::move(x).erf();
+}
+
+Arb Arb::erf_inv() const & {
     Arb ans;
-    arb_hypgeom_erfinv(ans.t, this -> t, GLOBAL_PRECISION);
+    _arb_monotone(ans.t, this -> t, arb_hypgeom_erfinv, Precision::get());
     return ans;
 }
 
+Arb Arb::erf_inv() && {
+    _arb_monotone(this -> t, this -> t, arb_hypgeom_erfinv, Precision::get());
+    return std::move(*this);
+}
+
 Arb Arb::erf_inv(const Arb& x) {
     return x.erf_inv();
 }
 
-Arb Arb::norm_pdf() const {
-    return exp((this->pow(2)) / (-2)) / sqrt(2*pi());
+Arb Arb::erf_inv(Arb&& x) {
+    return std::move(x).erf_inv();
+}
+
+Arb Arb::norm_pdf() const & {
+    Arb ans;
+    _arb_norm_pdf(ans.t, this -> t, Precision::get());
+    return ans;
+}
+
+Arb Arb::norm_pdf() && {
+    _arb_norm_pdf(this -> t, this -> t, Precision::get());
+    return std::move(*this);
 }
 
 Arb Arb::norm_pdf(const Arb& x) {
     return x.norm_pdf();
 }
 
-Arb Arb::norm_cdf() const {
-    return (1 + ((*this)/sqrt(2)).erf())/2;
+Arb Arb::norm_pdf(Arb&& x) {
+    return std::move(x).norm_pdf();
+}
+
+Arb Arb::norm_cdf() const & {
+    Arb ans;
+    _arb_monotone(ans.t, this -> t, _arb_norm_cdf, Precision::get());
+    return ans;
+}
+
+Arb Arb::norm_cdf() && {
+    _arb_monotone(this -> t, this -> t, _arb_norm_cdf, Precision::get());
+    return std::move(*this);
 }
 
 Arb Arb::norm_cdf(const Arb& x) {
     return x.norm_cdf();
 }
 
-Arb Arb::norm_cdf_inv() const {
-    return sqrt(2)*erf_inv(2*(*this)-1);
+Arb Arb::norm_cdf(Arb&& x) {
+    return std::move(x).norm_cdf();
+}
+
+Arb Arb::norm_sf() const & {
+    Arb ans;
+    _arb_monotone(ans.t, this -> t, _arb_norm_sf, Precision::get());
+    return ans;
+}
+
+Arb Arb::norm_sf() && {
+    _arb_monotone(this -> t, this -> t, _arb_norm_sf, Precision::get());
+    return std::move(*this);
+}
+
+Arb Arb::norm_sf(const Arb& x) {
+    return x.norm_sf();
+}
+
+Arb Arb::norm_sf(Arb&& x) {
+    return std::move(x).norm_sf();
+}
+
+Arb Arb::log_norm_cdf() const & {
+    Arb ans;
+    _arb_monotone(ans.t, this -> t, _arb_log_norm_cdf, Precision::get());
+    return ans;
+}
+
+Arb Arb::log_norm_cdf() && {
+    _arb_monotone(this -> t, this -> t, _arb_log_norm_cdf, Precision::get());
+    return std::move(*this);
+}
+
+Arb Arb::log_norm_cdf(const Arb& x) {
+    return x.log_norm_cdf();
+}
+
+Arb Arb::log_norm_cdf(Arb&& x) {
+    return std::move(x).log_norm_cdf();
+}
+
+Arb Arb::mills_ratio() const & {
+    Arb ans;
+    _arb_monotone(ans.t, this -> t, _arb_mills_ratio, Precision::get());
+    return ans;
+}
+
+Arb Arb::mills_ratio() && {
+    _arb_monotone(this -> t, this -> t, _arb_mills_ratio, Precision::get());
+    return std::move(*this);
+}
+
+Arb Arb::mills_ratio(const Arb& x) {
+    return x.mills_ratio();
+}
+
+Arb Arb::mills_ratio(Arb&& x) {
+    return std::move(x).mills_ratio();
+}
+
+Arb Arb::norm_cdf_inv() const & {
+    Arb ans;
+    _arb_monotone(ans.t, this -> t, _arb_norm_cdf_inv, Precision::get());
+    return ans;
+}
+
+Arb Arb::norm_cdf_inv() && {
+    _arb_monotone(this -> t, this -> t, _arb_norm_cdf_inv, Precision::get());
+    return std::move(*this);
 }
 
 Arb Arb::norm_cdf_inv(const Arb& x) {
     return x.norm_cdf_inv();
 }
+
+Arb Arb::norm_cdf_inv(Arb&& x) {
+    return std::move(x).norm_cdf_inv();
+}
+
+Arb Arb::norm_cdf_inv_erf() const & {
+    Arb ans;
+    _arb_monotone(ans.t, this -> t, _arb_norm_cdf_inv_erf, Precision::get());
+    return ans;
+}
+
+Arb Arb::norm_cdf_inv_erf() && {
+    _arb_monotone(this -> t, this -> t, _arb_norm_cdf_inv_erf, Precision::get());
+    return std::move(*this);
+}
+
+Arb Arb::norm_cdf_inv_erf(const Arb& x) {
+    return x.norm_cdf_inv_erf();
+}
+
+Arb Arb::norm_cdf_inv_erf(Arb&& x) {
+    return std::move(x).norm_cdf_inv_erf();
+}
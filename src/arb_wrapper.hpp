@@ -7,9 +7,9 @@
 #ifndef ARB_WRAPPER_HPP
 #define ARB_WRAPPER_HPP
 
-#define GLOBAL_PRECISION 64 // Move this to a global file
-
 #include "arb.h"
+#include "precision.hpp"
+#include <utility>
 
 class Arb {
 public:
@@ -19,6 +19,13 @@ public:
     Arb(double d); // 0-length interval around d
     
     Arb(double d1, double d2); // interval between d1 and d2
+
+    // copy/move -- moving just swaps the underlying arb_t
+    Arb(const Arb& x);
+    Arb(Arb&& x) noexcept;
+
+    Arb& operator=(const Arb& rhs);
+    Arb& operator=(Arb&& rhs) noexcept;
     
     // destructor
     virtual ~Arb();
@@ -31,17 +38,40 @@ public:
     void pretty_println() const;
 
     // internal operators
-    Arb operator-() const; //unary negation
-
-    Arb operator+(const Arb& rhs) const;
-    Arb operator-(const Arb& rhs) const;
-    Arb operator*(const Arb& rhs) const;
-    Arb operator/(const Arb& rhs) const;
-
-    Arb operator+(double rhs) const;
-    Arb operator-(double rhs) const;
-    Arb operator*(double rhs) const;
-    Arb operator/(double rhs) const;
+    // the && overloads write into the storage of the temporary
+    // operand instead of initializing a fresh arb_t
+    Arb operator-() const &; //unary negation
+    Arb operator-() &&;
+
+    Arb operator+(const Arb& rhs) const &;
+    Arb operator-(const Arb& rhs) const &;
+    Arb operator*(const Arb& rhs) const &;
+    Arb operator/(const Arb& rhs) const &;
+
+    Arb operator+(const Arb& rhs) &&;
+    Arb operator-(const Arb& rhs) &&;
+    Arb operator*(const Arb& rhs) &&;
+    Arb operator/(const Arb& rhs) &&;
+
+    Arb operator+(Arb&& rhs) const &;
+    Arb operator-(Arb&& rhs) const &;
+    Arb operator*(Arb&& rhs) const &;
+    Arb operator/(Arb&& rhs) const &;
+
+    Arb operator+(Arb&& rhs) &&;
+    Arb operator-(Arb&& rhs) &&;
+    Arb operator*(Arb&& rhs) &&;
+    Arb operator/(Arb&& rhs) &&;
+
+    Arb operator+(double rhs) const &;
+    Arb operator-(double rhs) const &;
+    Arb operator*(double rhs) const &;
+    Arb operator/(double rhs) const &;
+
+    Arb operator+(double rhs) &&;
+    Arb operator-(double rhs) &&;
+    Arb operator*(double rhs) &&;
+    Arb operator/(double rhs) &&;
 
     // these interval operators are "for all"
     // x in lhs and y in rhs is op true?
@@ -57,8 +87,10 @@ public:
     int operator>=(const Arb& rhs) const;
   
     // interval arithmetic operations
-    Arb join(const Arb& rhs) const;
+    Arb join(const Arb& rhs) const &;
+    Arb join(const Arb& rhs) &&;
     static Arb join(const Arb& lhs, const Arb& rhs);
+    static Arb join(Arb&& lhs, const Arb& rhs);
 
     Arb intersect(const Arb& rhs) const;
     static Arb intersect(const Arb& lhs, const Arb& rhs);
@@ -74,59 +106,138 @@ public:
     Arb mid() const;
     Arb rad() const;
 
+    // exact endpoints, as balls of radius 0
     Arb left_edge() const;
     Arb right_edge() const;
 
+    // the halves [lo, mid] and [mid, hi], computed exactly, so they
+    // share only the midpoint; a non-finite ball is returned unchanged
     Arb left_half() const;
     Arb right_half() const;
+    std::pair<Arb, Arb> split() const;
+    // piece index (from the left) of the 2^level equal pieces, the same
+    // ball as level exact halvings; 0 <= index < 2^level, level <= 62
+    Arb dyadic_piece(slong level, ulong index) const;
 
     static Arb nan();
     int is_nan() const;
 
     // mathematical constants and functions
+    // constants are cached per thread and precision, see _arb_const
     static Arb pi();
+    static Arb sqrt2();
+    static Arb inv_sqrt2();
+    static Arb inv_sqrt_2pi();
+    static Arb log_2pi();
 
-    Arb abs() const;
+    Arb abs() const &;
+    Arb abs() &&;
     static Arb abs(const Arb& x);
+    static Arb abs(Arb&& x);
 
-    Arb min(const Arb& rhs) const;
+    Arb min(const Arb& rhs) const &;
+    Arb min(const Arb& rhs) &&;
     static Arb min(const Arb& lhs, const Arb& rhs);
+    static Arb min(Arb&& lhs, const Arb& rhs);
 
-    Arb max(const Arb& rhs) const;
+    Arb max(const Arb& rhs) const &;
+    Arb max(const Arb& rhs) &&;
     static Arb max(const Arb& lhs, const Arb& rhs);
+    static Arb max(Arb&& lhs, const Arb& rhs);
 
-    Arb exp() const;
+    Arb exp() const &;
+    Arb exp() &&;
     static Arb exp(const Arb& x);
+    static Arb exp(Arb&& x);
 
-    Arb sqrt() const;
+    Arb sqrt() const &;
+    Arb sqrt() &&;
     static Arb sqrt(const Arb& x);
+    static Arb sqrt(Arb&& x);
 
     // sqrt(max(x,0))
-    Arb safe_sqrt() const;
+    Arb safe_sqrt() const &;
+    Arb safe_sqrt() &&;
     static Arb safe_sqrt(const Arb& x);
+    static Arb safe_sqrt(Arb&& x);
 
-    Arb sqr() const;
+    Arb sqr() const &;
+    Arb sqr() &&;
     static Arb sqr(const Arb& x);
+    static Arb sqr(Arb&& x);
+
+    Arb atan() const &;
+    Arb atan() &&;
+    static Arb atan(const Arb& x);
+    static Arb atan(Arb&& x);
+
+    Arb asin() const &;
+    Arb asin() &&;
+    static Arb asin(const Arb& x);
+    static Arb asin(Arb&& x);
 
-    Arb pow(const Arb& rhs) const;
+    Arb pow(const Arb& rhs) const &;
+    Arb pow(const Arb& rhs) &&;
     static Arb pow(const Arb& lhs, const Arb& rhs);
+    static Arb pow(Arb&& lhs, const Arb& rhs);
 
-    Arb erf() const;
+    // erf, erf_inv and the norm_* functions below are monotone, so balls
+    // with radius above 2^monotone_threshold() are evaluated at their two
+    // endpoints and joined; this is tighter than propagating a wide ball
+    static slong monotone_threshold();
+    static void set_monotone_threshold(slong e);
+
+    Arb erf() const &;
+    Arb erf() &&;
     static Arb erf(const Arb& x);
+    static Arb erf(Arb&& x);
 
-    Arb erf_inv() const;
+    Arb erf_inv() const &;
+    Arb erf_inv() &&;
     static Arb erf_inv(const Arb& x);
+    static Arb erf_inv(Arb&& x);
 
     // following functions are for the standard Gaussian
     // with mean 0 and variance 1
-    Arb norm_pdf() const;
+    Arb norm_pdf() const &;
+    Arb norm_pdf() &&;
     static Arb norm_pdf(const Arb& x);
+    static Arb norm_pdf(Arb&& x);
 
-    Arb norm_cdf() const;
+    Arb norm_cdf() const &;
+    Arb norm_cdf() &&;
     static Arb norm_cdf(const Arb& x);
-
-    Arb norm_cdf_inv() const;
+    static Arb norm_cdf(Arb&& x);
+
+    // upper tail 1 - norm_cdf(x), without cancellation for large x
+    Arb norm_sf() const &;
+    Arb norm_sf() &&;
+    static Arb norm_sf(const Arb& x);
+    static Arb norm_sf(Arb&& x);
+
+    // log(norm_cdf(x)), accurate in both tails
+    Arb log_norm_cdf() const &;
+    Arb log_norm_cdf() &&;
+    static Arb log_norm_cdf(const Arb& x);
+    static Arb log_norm_cdf(Arb&& x);
+
+    // Mills ratio norm_sf(x) / norm_pdf(x)
+    Arb mills_ratio() const &;
+    Arb mills_ratio() &&;
+    static Arb mills_ratio(const Arb& x);
+    static Arb mills_ratio(Arb&& x);
+
+    // certified by interval Newton from a double seed, falling back to
+    // norm_cdf_inv_erf, i.e. sqrt(2) * erf_inv(2x - 1), when that fails
+    Arb norm_cdf_inv() const &;
+    Arb norm_cdf_inv() &&;
     static Arb norm_cdf_inv(const Arb& x);
+    static Arb norm_cdf_inv(Arb&& x);
+
+    Arb norm_cdf_inv_erf() const &;
+    Arb norm_cdf_inv_erf() &&;
+    static Arb norm_cdf_inv_erf(const Arb& x);
+    static Arb norm_cdf_inv_erf(Arb&& x);
 
     // internal data -- should be private, but breaks acb_wrapper
     arb_t t;
@@ -140,4 +251,39 @@ Arb operator-(double lhs, const Arb& rhs);
 Arb operator*(double lhs, const Arb& rhs);
 Arb operator/(double lhs, const Arb& rhs);
 
+Arb operator+(double lhs, Arb&& rhs);
+Arb operator-(double lhs, Arb&& rhs);
+Arb operator*(double lhs, Arb&& rhs);
+Arb operator/(double lhs, Arb&& rhs);
+
+// constants cached by _arb_const
+enum ArbConst {
+    ARB_CONST_PI,
+    ARB_CONST_SQRT2,
+    ARB_CONST_INV_SQRT2,     // 1/sqrt(2)
+    ARB_CONST_INV_SQRT_2PI,  // 1/sqrt(2*pi)
+    ARB_CONST_LOG_2PI,       // log(2*pi)
+    ARB_NUM_CONSTS
+};
+
+// the constant c at precision prec, computed on first use by each thread
+// the pointer stays valid until the thread exits
+arb_srcptr _arb_const(ArbConst c, slong prec);
+
+// kernels for arithmetic with a double, shared with arb_expr.hpp
+// none of these builds a temporary Arb: integers go through the _si
+// functions, powers of two through arb_mul_2exp_si and any other
+// (exactly representable) double through a stack arf
+// res may alias x
+void _arb_add_d(arb_t res, const arb_t x, double d, slong prec);
+void _arb_sub_d(arb_t res, const arb_t x, double d, slong prec);
+void _arb_mul_d(arb_t res, const arb_t x, double d, slong prec);
+void _arb_div_d(arb_t res, const arb_t x, double d, slong prec);
+void _arb_d_sub(arb_t res, double d, const arb_t x, slong prec);
+void _arb_d_div(arb_t res, double d, const arb_t x, slong prec);
+
+// d as a machine integer / d as a signed power of two, if possible
+int _d_is_si(double d, slong& n);
+int _d_is_pow2(double d, slong& e);
+
 #endif
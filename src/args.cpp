@@ -0,0 +1,87 @@
+/*
+  Copyright (c) 2022-23 Joshua Brakensiek, Neng Huang, Aaron Potechin and Uri Zwick
+
+  This code is licensed under the MIT License.
+*/
+
+#include "args.hpp"
+#include "arb_wrapper.hpp"
+#include "bivariate_normal.hpp"
+#include "precision.hpp"
+#include "escalate.hpp"
+#include "biv_cache.hpp"
+#include "biv_store.hpp"
+#include "biv_model.hpp"
+#include "verify.hpp"
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+
+const char* arg_str(int argc, char* argv[], const char* name) {
+    size_t n = strlen(name);
+    // the last occurrence wins
+    for (int i = argc - 1; i >= 1; i--) {
+        const char* a = argv[i];
+        if (strncmp(a, "--", 2) == 0 && strncmp(a + 2, name, n) == 0
+            && a[2 + n] == '=') {
+            return a + 3 + n;
+        }
+    }
+    return NULL;
+}
+
+slong arg_slong(int argc, char* argv[], const char* name, slong fallback) {
+    const char* v = arg_str(argc, argv, name);
+    if (v == NULL) {
+        return fallback;
+    }
+    char* end;
+    slong ans = strtol(v, &end, 10);
+    // reject garbage like --prec=64x
+    assert(*v != '\0' && *end == '\0');
+    return ans;
+}
+
+void parse_common_args(int argc, char* argv[]) {
+    Precision::set_default(arg_slong(argc, argv, "prec", DEFAULT_PRECISION));
+    escalate_set_max_prec(arg_slong(argc, argv, "max-prec", 0));
+    Arb::set_monotone_threshold(arg_slong(argc, argv, "monotone-rad",
+                                          Arb::monotone_threshold()));
+    biv_cache_set_capacity(arg_slong(argc, argv, "biv-cache", biv_cache_capacity()));
+    verify_set_threads(arg_slong(argc, argv, "threads", verify_threads()));
+    verify_set_spawn_depth(arg_slong(argc, argv, "spawn-depth", verify_spawn_depth()));
+    verify_set_max_depth_cap(arg_slong(argc, argv, "max-depth", verify_max_depth_cap()));
+    verify_set_max_boxes_cap(arg_slong(argc, argv, "max-boxes", verify_max_boxes_cap()));
+    verify_set_report(arg_str(argc, argv, "report"));
+
+    // before the store, whose header names the engine
+    const char* engine = arg_str(argc, argv, "biv-engine");
+    if (engine != NULL) {
+        if (strcmp(engine, "quadrature") == 0) {
+            biv_norm_set_engine(BIV_NORM_QUADRATURE);
+        }
+        else if (strcmp(engine, "owen-t") == 0) {
+            biv_norm_set_engine(BIV_NORM_OWEN_T);
+        }
+        else if (strcmp(engine, "cross-check") == 0) {
+            biv_norm_set_engine(BIV_NORM_CROSS_CHECK);
+        }
+        else {
+            flint_printf("unknown --biv-engine=%s\n", engine);
+            assert(0);
+        }
+    }
+
+    const char* store = arg_str(argc, argv, "biv-store");
+    if (store != NULL) {
+        biv_store_set_capacity(arg_slong(argc, argv, "biv-store-max", biv_store_capacity()));
+        // without the file the run is only slower, never wrong
+        biv_store_open(store);
+    }
+
+    const char* model = arg_str(argc, argv, "biv-model");
+    if (model != NULL) {
+        int ok = biv_model_load(model);
+        assert(ok);
+    }
+}
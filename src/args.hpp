@@ -0,0 +1,36 @@
+/*
+  Copyright (c) 2022-23 Joshua Brakensiek, Neng Huang, Aaron Potechin and Uri Zwick
+
+  This code is licensed under the MIT License.
+*/
+
+#ifndef ARGS_HPP
+#define ARGS_HPP
+
+#include "flint.h"
+
+// Minimal command line handling for the experiments.
+// Options are of the form --name=value; anything else is ignored.
+
+// the value of --name=..., or NULL if it was not given
+const char* arg_str(int argc, char* argv[], const char* name);
+
+slong arg_slong(int argc, char* argv[], const char* name, slong fallback);
+
+// handles the options shared by every binary:
+//   --prec=N            working precision in bits (default 64)
+//   --max-prec=N        precision cap for escalate() (default: --prec)
+//   --monotone-rad=E    endpoint evaluation above radius 2^E (default -16)
+//   --biv-engine=NAME   quadrature (default), owen-t or cross-check
+//   --biv-cache=N       memoized biv_norm_cdf_unsafe values (default 65536)
+//   --biv-store=PATH    also memoize them in a file shared across runs
+//   --biv-store-max=N   records of that file indexed and appended (default 1048576)
+//   --biv-model=PATH    certified model to use inside its box (biv-model-fit)
+//   --threads=N         threads of the box search (default 1)
+//   --spawn-depth=D     splits up to this deep are shared between threads (default 24)
+//   --max-depth=N       a box still undecided after N splits fails (default: no cap)
+//   --max-boxes=N       a split leaving over N boxes waiting fails (default: no cap)
+//   --report=PATH       where to describe the box that failed (default stdout)
+void parse_common_args(int argc, char* argv[]);
+
+#endif
@@ -0,0 +1,154 @@
+/*
+  Copyright (c) 2022-23 Joshua Brakensiek, Neng Huang, Aaron Potechin and Uri Zwick
+
+  This code is licensed under the MIT License.
+*/
+
+#include "biv_cache.hpp"
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+typedef std::list<std::pair<BivCacheKey, Arb>> _BivCacheList;
+
+// front of the list is the most recently used
+static std::mutex cache_mutex;
+static _BivCacheList cache_list;
+static std::unordered_map<BivCacheKey, _BivCacheList::iterator, BivCacheKeyHash> cache_map;
+static std::atomic<slong> capacity(BIV_CACHE_DEFAULT_CAPACITY);
+
+static std::atomic<slong> hits(0), misses(0);
+
+static int _biv_cache_ball(BivCacheBall &b, const Arb &x) {
+    const arf_struct* mid = arb_midref(x.t);
+    const mag_struct* rad = arb_radref(x.t);
+    // special values (0, inf, nan) have small exponents and no limbs
+    if (COEFF_IS_MPZ(*ARF_EXPREF(mid)) || COEFF_IS_MPZ(*MAG_EXPREF(rad))) {
+        return 0;
+    }
+    b.mid_exp = ARF_EXP(mid);
+    b.mid_size = ARF_XSIZE(mid);
+    if (ARF_IS_SPECIAL(mid)) {
+        b.mid_size = 0;
+    }
+    else {
+        mp_srcptr d;
+        mp_size_t n;
+        ARF_GET_MPN_READONLY(d, n, mid);
+        if (n > BIV_CACHE_KEY_LIMBS) {
+            return 0;
+        }
+        memcpy(b.mid, d, n * sizeof(mp_limb_t));
+    }
+    b.rad_exp = MAG_EXP(rad);
+    b.rad_man = MAG_MAN(rad);
+    return 1;
+}
+
+int biv_cache_key(BivCacheKey &key, const Arb &t1, const Arb &t2, const Arb &rho) {
+    memset(&key, 0, sizeof(key));
+    key.prec = Precision::get();
+    if (!_biv_cache_ball(key.x[0], t1) || !_biv_cache_ball(key.x[1], t2) ||
+        !_biv_cache_ball(key.x[2], rho)) {
+        return 0;
+    }
+
+    // multiply-xorshift over the words before the hash
+    const ulong* w = (const ulong*) &key;
+    ulong h = 0;
+    for (size_t i = 0; i < offsetof(BivCacheKey, hash) / sizeof(ulong); i++) {
+        h = (h ^ w[i]) * 0x9e3779b97f4a7c15UL;
+        h ^= h >> 29;
+    }
+    key.hash = h;
+    return 1;
+}
+
+int BivCacheKey::operator==(const BivCacheKey &k) const {
+    return memcmp(this, &k, sizeof(k)) == 0;
+}
+
+// caller holds cache_mutex
+static void _biv_cache_trim() {
+    while ((slong) cache_list.size() > capacity.load()) {
+        cache_map.erase(cache_list.back().first);
+        cache_list.pop_back();
+    }
+}
+
+slong biv_cache_capacity() {
+    return capacity.load();
+}
+
+void biv_cache_set_capacity(slong n) {
+    assert(n >= 0);
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    capacity = n;
+    _biv_cache_trim();
+}
+
+void biv_cache_clear() {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    cache_map.clear();
+    cache_list.clear();
+}
+
+int biv_cache_lookup(Arb &res, const Arb &t1, const Arb &t2, const Arb &rho) {
+    BivCacheKey key;
+    if (capacity.load() == 0 || !biv_cache_key(key, t1, t2, rho)) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    auto it = cache_map.find(key);
+    if (it == cache_map.end()) {
+        misses.fetch_add(1, std::memory_order_relaxed);
+        return 0;
+    }
+    cache_list.splice(cache_list.begin(), cache_list, it->second);
+    res = it->second->second;
+    hits.fetch_add(1, std::memory_order_relaxed);
+    return 1;
+}
+
+void biv_cache_store(const Arb &t1, const Arb &t2, const Arb &rho, const Arb &val) {
+    BivCacheKey key;
+    if (capacity.load() == 0 || !biv_cache_key(key, t1, t2, rho)) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    auto it = cache_map.find(key);
+    if (it != cache_map.end()) {
+        // another thread got here first; both values are rigorous
+        cache_list.splice(cache_list.begin(), cache_list, it->second);
+        return;
+    }
+    cache_list.emplace_front(key, val);
+    cache_map.emplace(key, cache_list.begin());
+    _biv_cache_trim();
+}
+
+slong biv_cache_hits() {
+    return hits.load(std::memory_order_relaxed);
+}
+
+slong biv_cache_misses() {
+    return misses.load(std::memory_order_relaxed);
+}
+
+slong biv_cache_size() {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    return cache_list.size();
+}
+
+void biv_cache_print_stats() {
+    flint_printf("BIV CACHE: %wd hits, %wd misses, %wd stored (cap %wd)\n",
+                 biv_cache_hits(), biv_cache_misses(), biv_cache_size(),
+                 biv_cache_capacity());
+}
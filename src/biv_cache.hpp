@@ -0,0 +1,71 @@
+/*
+  Copyright (c) 2022-23 Joshua Brakensiek, Neng Huang, Aaron Potechin and Uri Zwick
+
+  This code is licensed under the MIT License.
+*/
+
+#ifndef BIV_CACHE_HPP
+#define BIV_CACHE_HPP
+
+#include "arb_wrapper.hpp"
+
+// Memoization of biv_norm_cdf_unsafe.
+//
+// Bisection children share their edges with their parent and siblings,
+// so the same (t1, t2, rho) endpoints are evaluated over and over. This
+// is a least-recently-used cache shared by all threads, keyed on the
+// exact bits of the three balls and the precision. It holds at most
+// --biv-cache=N values (default 65536; 0 turns it off).
+
+#define BIV_CACHE_DEFAULT_CAPACITY 65536
+// midpoints with more limbs than this are not memoized
+#define BIV_CACHE_KEY_LIMBS 4
+
+// the exact bits of one ball: the midpoint's exponent, signed size and
+// limbs (unused limbs are 0), the radius' exponent and mantissa
+class BivCacheBall {
+public:
+    slong mid_exp;
+    slong mid_size;
+    mp_limb_t mid[BIV_CACHE_KEY_LIMBS];
+    slong rad_exp;
+    mp_limb_t rad_man;
+};
+
+// exact key of (precision, t1, t2, rho): fixed size with no padding, so it
+// is compared, hashed and written out as plain bytes
+class BivCacheKey {
+public:
+    slong prec;
+    BivCacheBall x[3];
+    // of the fields above, filled in by biv_cache_key
+    ulong hash;
+
+    int operator==(const BivCacheKey &k) const;
+};
+
+class BivCacheKeyHash {
+public:
+    size_t operator()(const BivCacheKey &k) const {
+        return k.hash;
+    }
+};
+
+slong biv_cache_capacity();
+// shrinking drops the least recently used values
+void biv_cache_set_capacity(slong n);
+void biv_cache_clear();
+
+// 1 and sets res on a hit
+int biv_cache_lookup(Arb &res, const Arb &t1, const Arb &t2, const Arb &rho);
+void biv_cache_store(const Arb &t1, const Arb &t2, const Arb &rho, const Arb &val);
+
+// 0 if a ball has a huge exponent or too many limbs to be a key
+int biv_cache_key(BivCacheKey &key, const Arb &t1, const Arb &t2, const Arb &rho);
+
+slong biv_cache_hits();
+slong biv_cache_misses();
+slong biv_cache_size();
+void biv_cache_print_stats();
+
+#endif
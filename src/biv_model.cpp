@@ -0,0 +1,290 @@
+/*
+  Copyright (c) 2022-23 Joshua Brakensiek, Neng Huang, Aaron Potechin and Uri Zwick
+
+  This code is licensed under the MIT License.
+*/
+
+#include "biv_model.hpp"
+#include "bivariate_normal.hpp"
+#include "arb_expr.hpp"
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <utility>
+
+// T_j(u), and T_j'(u) if dT is not NULL, for j <= n
+static void _cheb(Arb* T, Arb* dT, const Arb &u, slong n) {
+    T[0] = 1;
+    if (dT) dT[0] = 0;
+    if (n >= 1) {
+        T[1] = u;
+        if (dT) dT[1] = 1;
+    }
+    for (slong j = 1; j < n; j++) {
+        T[j + 1] = 2 * u * T[j] - T[j - 1];
+        if (dT) dT[j + 1] = 2 * T[j] + 2 * u * dT[j] - dT[j - 1];
+    }
+}
+
+// sum_{a,b,c} coeffs[a,b,c] A_a B_b C_c
+static Arb _cheb_sum(const std::vector<Arb> &coeffs, slong n,
+                     const Arb* A, const Arb* B, const Arb* C) {
+    slong prec = Precision::get();
+    slong n1 = n + 1;
+    Arb ans(0);
+    for (slong a = 0; a < n1; a++) {
+        Arb sa(0);
+        for (slong b = 0; b < n1; b++) {
+            Arb sb(0);
+            for (slong c = 0; c < n1; c++) {
+                arb_addmul(sb.t, coeffs[(a * n1 + b) * n1 + c].t, C[c].t, prec);
+            }
+            arb_addmul(sa.t, sb.t, B[b].t, prec);
+        }
+        arb_addmul(ans.t, sa.t, A[a].t, prec);
+    }
+    return ans;
+}
+
+// center and half-width of each side
+static void _frame(const Arb lo[3], const Arb hi[3], Arb c[3], Arb r[3]) {
+    for (int i = 0; i < 3; i++) {
+        c[i] = (lazy(lo[i]) + hi[i]) / 2;
+        r[i] = (lazy(hi[i]) - lo[i]) / 2;
+    }
+}
+
+static Arb _to_unit(const Arb &x, const Arb &c, const Arb &r) {
+    if (arb_is_zero(r.t)) {
+        return 0;
+    }
+    return (lazy(x) - c) / r;
+}
+
+BivNormModel BivNormModel::fit(const Arb lo[3], const Arb hi[3], slong degree, slong cells) {
+    assert(degree >= 0 && cells >= 1);
+    assert(lo[2] > -RHO_THRESH && hi[2] < RHO_THRESH);
+
+    BivNormModel m;
+    for (int i = 0; i < 3; i++) {
+        assert(!(hi[i] < lo[i]));
+        m.lo[i] = lo[i];
+        m.hi[i] = hi[i];
+    }
+    m.degree = degree;
+    m.prec = Precision::get();
+
+    slong prec = Precision::get();
+    slong n1 = degree + 1;
+    slong size = n1 * n1 * n1;
+    Arb c[3], r[3];
+    _frame(lo, hi, c, r);
+
+    // interpolation only has to be accurate, not rigorous: the
+    // certification below bounds whatever error it leaves
+    std::vector<Arb> u(n1), T(n1 * n1);
+    for (slong k = 0; k < n1; k++) {
+        u[k] = cos(M_PI * (2 * k + 1) / (2 * n1));
+        _cheb(&T[k * n1], NULL, u[k], degree);
+    }
+
+    std::vector<Arb> w(size), tmp(size);
+    for (slong i = 0; i < size; i++) {
+        slong k[3] = {i / (n1 * n1), (i / n1) % n1, i % n1};
+        Arb x[3];
+        for (int d = 0; d < 3; d++) {
+            x[d] = c[d] + r[d] * u[k[d]];
+        }
+        w[i] = biv_norm_cdf_unsafe(x[0], x[1], x[2]);
+    }
+
+    // discrete Chebyshev transform along each axis in turn
+    for (int axis = 0; axis < 3; axis++) {
+        for (slong i = 0; i < size; i++) {
+            slong idx[3] = {i / (n1 * n1), (i / n1) % n1, i % n1};
+            slong j = idx[axis];
+            Arb s(0);
+            for (slong k = 0; k < n1; k++) {
+                idx[axis] = k;
+                arb_addmul(s.t, w[(idx[0] * n1 + idx[1]) * n1 + idx[2]].t,
+                           T[k * n1 + j].t, prec);
+            }
+            tmp[i] = s * (j == 0 ? 1 : 2) / n1;
+        }
+        std::swap(w, tmp);
+    }
+    for (slong i = 0; i < size; i++) {
+        arb_get_mid_arb(w[i].t, w[i].t);
+    }
+    m.coeffs = std::move(w);
+
+    // certify on cells^3 sub-boxes of [-1, 1]^3
+    std::vector<Arb> Tm(3 * n1), Tb(3 * n1), dTb(3 * n1);
+    Arb rem(0);
+    for (slong i = 0; i < cells * cells * cells; i++) {
+        slong k[3] = {i / (cells * cells), (i / cells) % cells, i % cells};
+        Arb um[3], hu[3], xm[3], xb[3];
+        for (int d = 0; d < 3; d++) {
+            // the sub-box is exactly the ball mid +/- rad
+            Arb ub = -1 + Arb(2 * k[d] + 1) / cells;
+            arb_add_error(ub.t, Arb(1 / Arb(cells)).t);
+            arb_get_mid_arb(um[d].t, ub.t);
+            arf_set_mag(arb_midref(hu[d].t), arb_radref(ub.t));
+            xm[d] = c[d] + r[d] * um[d];
+            xb[d] = c[d] + r[d] * ub;
+            _cheb(&Tm[d * n1], NULL, um[d], degree);
+            _cheb(&Tb[d * n1], &dTb[d * n1], ub, degree);
+        }
+
+        Arb bound = Arb::abs(biv_norm_cdf(xm[0], xm[1], xm[2]) -
+                             _cheb_sum(m.coeffs, degree, &Tm[0], &Tm[n1], &Tm[2 * n1]));
+
+        Arb df[3] = {biv_norm_cdf_d_t1(xb[0], xb[1], xb[2]),
+                     biv_norm_cdf_d_t2(xb[0], xb[1], xb[2]),
+                     biv_norm_cdf_d_rho(xb[0], xb[1], xb[2])};
+        Arb dp[3] = {_cheb_sum(m.coeffs, degree, &dTb[0], &Tb[n1], &Tb[2 * n1]),
+                     _cheb_sum(m.coeffs, degree, &Tb[0], &dTb[n1], &Tb[2 * n1]),
+                     _cheb_sum(m.coeffs, degree, &Tb[0], &Tb[n1], &dTb[2 * n1])};
+        for (int d = 0; d < 3; d++) {
+            bound = bound + Arb::abs(r[d] * df[d] - dp[d]) * hu[d];
+        }
+
+        rem = Arb::max(rem, bound.right_edge());
+    }
+    m.rem = rem.right_edge();
+    return m;
+}
+
+int BivNormModel::contains(const Arb &t1, const Arb &t2, const Arb &rho) const {
+    const Arb* x[3] = {&t1, &t2, &rho};
+    for (int i = 0; i < 3; i++) {
+        if (!(x[i]->left_edge() >= lo[i] && x[i]->right_edge() <= hi[i])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+Arb BivNormModel::eval(const Arb &t1, const Arb &t2, const Arb &rho) const {
+    slong n1 = degree + 1;
+    Arb c[3], r[3];
+    _frame(lo, hi, c, r);
+
+    const Arb* x[3] = {&t1, &t2, &rho};
+    std::vector<Arb> T(3 * n1);
+    for (int d = 0; d < 3; d++) {
+        _cheb(&T[d * n1], NULL, _to_unit(*x[d], c[d], r[d]), degree);
+    }
+
+    Arb ans = _cheb_sum(coeffs, degree, &T[0], &T[n1], &T[2 * n1]);
+    arb_add_error(ans.t, rem.t);
+    return ans;
+}
+
+// text format: a header line with the degree and the fit precision,
+// then one arb_dump_str per line for lo[0..2], hi[0..2], rem and the
+// coefficients
+int BivNormModel::save(const char* path) const {
+    FILE* f = fopen(path, "w");
+    if (f == NULL) {
+        return 0;
+    }
+    fprintf(f, "BIVMODEL 2 %ld %ld\n", (long) degree, (long) prec);
+    auto dump = [&](const Arb &x) {
+        char* s = arb_dump_str(x.t);
+        fprintf(f, "%s\n", s);
+        flint_free(s);
+    };
+    for (int i = 0; i < 3; i++) dump(lo[i]);
+    for (int i = 0; i < 3; i++) dump(hi[i]);
+    dump(rem);
+    for (const Arb& x : coeffs) dump(x);
+    return fclose(f) == 0;
+}
+
+int BivNormModel::load(const char* path) {
+    FILE* f = fopen(path, "r");
+    if (f == NULL) {
+        return 0;
+    }
+    long deg, fit_prec;
+    int ok = (fscanf(f, "BIVMODEL 2 %ld %ld\n", &deg, &fit_prec) == 2 && deg >= 0 && fit_prec > 0);
+
+    char* line = NULL;
+    size_t cap = 0;
+    auto read = [&](Arb &x) {
+        ssize_t n = getline(&line, &cap, f);
+        if (n <= 0) {
+            return 0;
+        }
+        if (line[n - 1] == '\n') {
+            line[n - 1] = '\0';
+        }
+        return (int) (arb_load_str(x.t, line) == 0);
+    };
+
+    if (ok) {
+        degree = deg;
+        prec = fit_prec;
+        coeffs.resize((deg + 1) * (deg + 1) * (deg + 1));
+        for (int i = 0; i < 3; i++) ok = ok && read(lo[i]);
+        for (int i = 0; i < 3; i++) ok = ok && read(hi[i]);
+        ok = ok && read(rem);
+        for (Arb& x : coeffs) ok = ok && read(x);
+    }
+
+    free(line);
+    fclose(f);
+    return ok;
+}
+
+// the loaded model is set up before any worker starts and never changes
+static std::unique_ptr<BivNormModel> active;
+static std::atomic<int> enabled(1);
+static std::atomic<slong> hits(0);
+
+int biv_model_load(const char* path) {
+    std::unique_ptr<BivNormModel> m(new BivNormModel());
+    if (!m->load(path)) {
+        flint_printf("biv model %s: cannot load\n", path);
+        return 0;
+    }
+    active = std::move(m);
+    return 1;
+}
+
+void biv_model_set_enabled(int e) {
+    enabled.store(e, std::memory_order_relaxed);
+}
+
+int biv_model_lookup(Arb &res, const Arb &t1, const Arb &t2, const Arb &rho) {
+    if (!active || !enabled.load(std::memory_order_relaxed)) {
+        return 0;
+    }
+    // a model fitted at lower precision, or whose remainder alone is
+    // wider than 2^-prec, would be looser than the quadrature (rem is
+    // exact: the right edge of the bound)
+    slong prec = Precision::get();
+    if (prec > active->prec || arf_cmp_2exp_si(arb_midref(active->rem.t), -prec) > 0 ||
+        !active->contains(t1, t2, rho)) {
+        return 0;
+    }
+    res = active->eval(t1, t2, rho);
+    hits.fetch_add(1, std::memory_order_relaxed);
+    return 1;
+}
+
+slong biv_model_hits() {
+    return hits.load(std::memory_order_relaxed);
+}
+
+void biv_model_print_stats() {
+    if (!active) {
+        return;
+    }
+    flint_printf("BIV MODEL: %wd evaluations, remainder ", biv_model_hits());
+    active->rem.println();
+}
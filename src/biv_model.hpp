@@ -0,0 +1,61 @@
+/*
+  Copyright (c) 2022-23 Joshua Brakensiek, Neng Huang, Aaron Potechin and Uri Zwick
+
+  This code is licensed under the MIT License.
+*/
+
+#ifndef BIV_MODEL_HPP
+#define BIV_MODEL_HPP
+
+#include "arb_wrapper.hpp"
+#include <vector>
+
+// Certified polynomial model of biv_norm_cdf over a box.
+//
+// With u_i = (x_i - c_i)/r_i the box is mapped to [-1, 1]^3 and
+//   p(u) = sum_{a,b,c <= n} coeffs[(a (n+1) + b)(n+1) + c] T_a(u1) T_b(u2) T_c(u3)
+// interpolates biv_norm_cdf(t1, t2, rho) at the Chebyshev points. The
+// coefficients are exact, and rem bounds |biv_norm_cdf - p| on the whole
+// box: on each of cells^3 sub-boxes B with center m,
+//   |f(x) - p(x)| <= |f(m) - p(m)| + sum_i |d_i f(B) - d_i p(B)| rad_i(B)
+// by the mean value theorem, with d_i f from the partials in
+// bivariate_normal. So eval() = p(x) +/- rem is an enclosure, and a
+// fitted model can be saved once and loaded by later runs
+// (--biv-model=PATH), after which biv_norm_cdf_unsafe is a few
+// multiply-adds inside the box. It is only used at or below the
+// precision it was fitted at, and while rem is within 2^-prec: beyond
+// that the quadrature would give a tighter ball.
+
+class BivNormModel {
+public:
+    // rho must stay inside (-RHO_THRESH, RHO_THRESH)
+    static BivNormModel fit(const Arb lo[3], const Arb hi[3], slong degree, slong cells);
+
+    int contains(const Arb &t1, const Arb &t2, const Arb &rho) const;
+    // only valid if contains(t1, t2, rho)
+    Arb eval(const Arb &t1, const Arb &t2, const Arb &rho) const;
+
+    int save(const char* path) const;
+    // 0 if the file is missing or malformed
+    int load(const char* path);
+
+    Arb lo[3], hi[3];
+    slong degree = 0;
+    std::vector<Arb> coeffs;
+    Arb rem;
+    // Precision::get() when fitted
+    slong prec = 0;
+};
+
+// the model used by biv_norm_cdf_unsafe, if any
+int biv_model_load(const char* path);
+// 0 makes biv_model_lookup miss, e.g. while fitting a new model
+void biv_model_set_enabled(int enabled);
+// 1 and sets res if (t1, t2, rho) lies in the loaded model's box and the
+// model suits the current precision
+int biv_model_lookup(Arb &res, const Arb &t1, const Arb &t2, const Arb &rho);
+
+slong biv_model_hits();
+void biv_model_print_stats();
+
+#endif
@@ -0,0 +1,286 @@
+/*
+  Copyright (c) 2022-23 Joshua Brakensiek, Neng Huang, Aaron Potechin and Uri Zwick
+
+  This code is licensed under the MIT License.
+*/
+
+#include "biv_store.hpp"
+#include "biv_cache.hpp"
+#include "bivariate_normal.hpp"
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define BIV_STORE_VERSION 3
+
+class _BivStoreHeader {
+public:
+    char magic[8];
+    // of the file layout
+    uint64_t version;
+    // of the code and the engine that computed the values
+    uint64_t revision;
+    uint64_t engine;
+    uint64_t checksum;
+};
+
+// FNV-1a
+static uint64_t _biv_store_hash(const char* data, size_t n) {
+    uint64_t h = 14695981039346656037ULL;
+    for (size_t i = 0; i < n; i++) {
+        h = (h ^ (unsigned char) data[i]) * 1099511628211ULL;
+    }
+    return h;
+}
+
+static void _biv_store_make_header(_BivStoreHeader &h) {
+    memcpy(h.magic, "BIVSTORE", 8);
+    h.version = BIV_STORE_VERSION;
+    h.revision = BIV_NORM_REVISION;
+    h.engine = biv_norm_engine();
+    h.checksum = _biv_store_hash((const char*) &h, offsetof(_BivStoreHeader, checksum));
+}
+
+static std::mutex store_mutex;
+static int store_fd = -1;
+static BivNormEngine store_engine = BIV_NORM_QUADRATURE;
+static char* store_map = NULL;
+static size_t store_map_len = 0;
+
+static slong store_capacity = BIV_STORE_DEFAULT_CAPACITY;
+// values point into the mapping, or into store_owned for this run's appends
+static std::unordered_map<std::string, std::pair<const char*, uint32_t>> store_index;
+static std::deque<std::string> store_owned;
+
+static std::atomic<slong> hits(0), appended(0);
+
+// indexes the records in [begin, end), up to the capacity, and returns
+// where the valid ones stop
+static size_t _biv_store_scan(const char* map, size_t begin, size_t end) {
+    size_t off = begin;
+    while (off + 8 <= end) {
+        uint32_t klen, vlen;
+        memcpy(&klen, map + off, 4);
+        memcpy(&vlen, map + off + 4, 4);
+        size_t body = 8 + (size_t) klen + vlen;
+        if (off + body + 8 > end) {
+            break;
+        }
+        uint64_t sum;
+        memcpy(&sum, map + off + body, 8);
+        if (sum != _biv_store_hash(map + off, body)) {
+            break;
+        }
+        if ((slong) store_index.size() < store_capacity) {
+            store_index.emplace(std::string(map + off + 8, klen),
+                                std::make_pair(map + off + 8 + klen, vlen));
+        }
+        off += body + 8;
+    }
+    return off;
+}
+
+static int _biv_store_fail(int fd, const char* path, const char* why) {
+    flint_printf("biv store %s: %s\n", path, why);
+    flock(fd, LOCK_UN);
+    close(fd);
+    return 0;
+}
+
+int biv_store_open(const char* path) {
+    std::lock_guard<std::mutex> lock(store_mutex);
+    assert(store_fd < 0);
+
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        flint_printf("biv store %s: cannot open\n", path);
+        return 0;
+    }
+    if (flock(fd, LOCK_EX) != 0) {
+        return _biv_store_fail(fd, path, "cannot lock");
+    }
+
+    _BivStoreHeader expect;
+    _biv_store_make_header(expect);
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        return _biv_store_fail(fd, path, "cannot stat");
+    }
+    size_t len = st.st_size;
+    if (len == 0) {
+        if (write(fd, &expect, sizeof(expect)) != (ssize_t) sizeof(expect)) {
+            return _biv_store_fail(fd, path, "cannot write header");
+        }
+        len = sizeof(expect);
+    }
+    else if (len < sizeof(expect)) {
+        return _biv_store_fail(fd, path, "bad header");
+    }
+
+    char* map = (char*) mmap(NULL, len, PROT_READ, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        return _biv_store_fail(fd, path, "cannot map");
+    }
+    if (memcmp(map, &expect, sizeof(expect)) != 0) {
+        // also a store of older code or another engine: its values may
+        // not be what this run would compute
+        munmap(map, len);
+        return _biv_store_fail(fd, path, "bad header");
+    }
+
+    // a run killed mid-append leaves a torn record; drop it
+    size_t valid = _biv_store_scan(map, sizeof(expect), len);
+    if (valid < len && ftruncate(fd, valid) != 0) {
+        munmap(map, len);
+        store_index.clear();
+        return _biv_store_fail(fd, path, "cannot truncate");
+    }
+
+    flock(fd, LOCK_UN);
+    store_fd = fd;
+    store_engine = biv_norm_engine();
+    store_map = map;
+    store_map_len = len;
+    return 1;
+}
+
+void biv_store_close() {
+    std::lock_guard<std::mutex> lock(store_mutex);
+    if (store_fd < 0) {
+        return;
+    }
+    store_index.clear();
+    store_owned.clear();
+    munmap(store_map, store_map_len);
+    close(store_fd);
+    store_fd = -1;
+    store_map = NULL;
+    store_map_len = 0;
+}
+
+int biv_store_is_open() {
+    std::lock_guard<std::mutex> lock(store_mutex);
+    return store_fd >= 0;
+}
+
+// the bytes of the biv_cache key, or "" if there is none
+static std::string _biv_store_key(const Arb &t1, const Arb &t2, const Arb &rho) {
+    BivCacheKey key;
+    if (!biv_cache_key(key, t1, t2, rho)) {
+        return std::string();
+    }
+    return std::string((const char*) &key, sizeof(key));
+}
+
+slong biv_store_capacity() {
+    std::lock_guard<std::mutex> lock(store_mutex);
+    return store_capacity;
+}
+
+void biv_store_set_capacity(slong n) {
+    std::lock_guard<std::mutex> lock(store_mutex);
+    store_capacity = FLINT_MAX(n, 0);
+}
+
+int biv_store_lookup(Arb &res, const Arb &t1, const Arb &t2, const Arb &rho) {
+    std::string key = _biv_store_key(t1, t2, rho);
+    if (key.empty()) {
+        return 0;
+    }
+    std::string val;
+    {
+        std::lock_guard<std::mutex> lock(store_mutex);
+        if (store_fd < 0 || biv_norm_engine() != store_engine) {
+            return 0;
+        }
+        auto it = store_index.find(key);
+        if (it == store_index.end()) {
+            return 0;
+        }
+        val.assign(it->second.first, it->second.second);
+    }
+    if (arb_load_str(res.t, val.c_str()) != 0) {
+        return 0;
+    }
+    hits.fetch_add(1, std::memory_order_relaxed);
+    return 1;
+}
+
+void biv_store_append(const Arb &t1, const Arb &t2, const Arb &rho, const Arb &val) {
+    if (!biv_store_is_open()) {
+        return;
+    }
+    std::string key = _biv_store_key(t1, t2, rho);
+    if (key.empty()) {
+        return;
+    }
+    char* s = arb_dump_str(val.t);
+    std::string value(s);
+    flint_free(s);
+
+    uint32_t klen = key.size(), vlen = value.size();
+    std::string rec;
+    rec.append((const char*) &klen, 4);
+    rec.append((const char*) &vlen, 4);
+    rec += key;
+    rec += value;
+    uint64_t sum = _biv_store_hash(rec.data(), rec.size());
+    rec.append((const char*) &sum, 8);
+
+    std::lock_guard<std::mutex> lock(store_mutex);
+    if (store_fd < 0 || biv_norm_engine() != store_engine || store_index.count(key) ||
+        (slong) store_index.size() >= store_capacity) {
+        return;
+    }
+    // one write per record, serialized with other processes
+    if (flock(store_fd, LOCK_EX) != 0) {
+        return;
+    }
+    off_t end = lseek(store_fd, 0, SEEK_END);
+    ssize_t n = (end < 0) ? -1 : write(store_fd, rec.data(), rec.size());
+    if (n != (ssize_t) rec.size() && n > 0) {
+        // a torn record would hide every later append from the next open,
+        // which truncates at it; take it back before anyone appends
+        if (ftruncate(store_fd, end) != 0) {
+            flint_printf("biv store: cannot undo a short write\n");
+        }
+    }
+    flock(store_fd, LOCK_UN);
+    if (n != (ssize_t) rec.size()) {
+        return;
+    }
+
+    const std::string& owned = store_owned.emplace_back(std::move(value));
+    store_index.emplace(std::move(key), std::make_pair(owned.data(), vlen));
+    appended.fetch_add(1, std::memory_order_relaxed);
+}
+
+slong biv_store_hits() {
+    return hits.load(std::memory_order_relaxed);
+}
+
+slong biv_store_size() {
+    std::lock_guard<std::mutex> lock(store_mutex);
+    return store_index.size();
+}
+
+void biv_store_print_stats() {
+    if (!biv_store_is_open()) {
+        return;
+    }
+    flint_printf("BIV STORE: %wd hits, %wd appended, %wd stored\n",
+                 biv_store_hits(), appended.load(), biv_store_size());
+}
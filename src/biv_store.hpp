@@ -0,0 +1,53 @@
+/*
+  Copyright (c) 2022-23 Joshua Brakensiek, Neng Huang, Aaron Potechin and Uri Zwick
+
+  This code is licensed under the MIT License.
+*/
+
+#ifndef BIV_STORE_HPP
+#define BIV_STORE_HPP
+
+#include "arb_wrapper.hpp"
+
+// Persistent memo of biv_norm_cdf_unsafe values across runs.
+//
+// With --biv-store=PATH, values missing from the in-process cache are
+// looked up in an append-only file, and newly computed ones are appended
+// to it. The file is a log, not a table: it is memory-mapped read-only
+// when opened and scanned once into a hash index on the heap, whose keys
+// are copies and whose values point into the mapping (or at copies of
+// this run's appends). Only the first biv_store_capacity() records are
+// indexed, and no record is appended once the index is full, so a large
+// file costs at most that many keys of memory and a longer scan at open.
+// Records are
+//   u32 key length, u32 value length, key, value, u64 checksum
+// after a header (magic, version, BIV_NORM_REVISION, engine, checksum):
+// a file written by other code or with another --biv-engine is refused,
+// and while the engine differs from the one the file was opened with it
+// is neither read nor written. Keys are the bytes of the same exact
+// BivCacheKey as biv_cache (so a file only suits machines with the same
+// word size and byte order), values are arb_dump_str of the enclosure,
+// so a stored value is exactly the ball that was computed. Appends take
+// an exclusive flock, so several runs may share a file (each stops
+// appending when its own index is full); a torn record at the end is
+// ignored and overwritten.
+
+#define BIV_STORE_DEFAULT_CAPACITY 1048576
+
+// 0 if the file cannot be opened or has a bad header
+int biv_store_open(const char* path);
+void biv_store_close();
+int biv_store_is_open();
+
+// records indexed by the next open (default BIV_STORE_DEFAULT_CAPACITY)
+slong biv_store_capacity();
+void biv_store_set_capacity(slong n);
+
+int biv_store_lookup(Arb &res, const Arb &t1, const Arb &t2, const Arb &rho);
+void biv_store_append(const Arb &t1, const Arb &t2, const Arb &rho, const Arb &val);
+
+slong biv_store_hits();
+slong biv_store_size();
+void biv_store_print_stats();
+
+#endif
@@ -5,8 +5,21 @@
 */
 
 #include "bivariate_normal.hpp"
+#include "arb_expr.hpp"
 #include "acb_calc.h"
+#include "arb_calc.h"
+#include "arb_hypgeom.h"
+#include "biv_cache.hpp"
+#include "biv_model.hpp"
+#include "biv_store.hpp"
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <utility>
+#include <vector>
 
 Arb biv_norm_cdf_norm_thresh(const Arb &t1, const Arb &t2, const Arb &rho) {
     // key observation: the problem is monotone in all three parameters
@@ -42,6 +55,13 @@ Arb biv_norm_cdf_norm_thresh(const Arb &t1, const Arb &t2, const Arb &rho) {
 }
 
 
+// narrow enough that the monotone functions evaluate it as a ball,
+// rather than at its two edges
+static int _biv_norm_narrow(const Arb &t) {
+    return arb_is_finite(t.t) &&
+        mag_cmp_2exp_si(arb_radref(t.t), Arb::monotone_threshold()) <= 0;
+}
+
 // any part of rho extending beyond +/-1 is ignored
 Arb biv_norm_cdf(const Arb &t1, const Arb &t2, const Arb &rho) {
     // key observation: the problem is monotone in all three parameters
@@ -57,6 +77,18 @@ Arb biv_norm_cdf(const Arb &t1, const Arb &t2, const Arb &rho) {
 
     Arb lower, upper;
 
+    // the same integrand at both ends: integrate [0, lo] and [lo, hi] once.
+    // Evaluated on narrow t balls, such as the norm_cdf_inv values from
+    // biv_norm_cdf_norm_thresh, each end encloses its value at every t in
+    // the balls, the edges included, so by monotonicity the join still
+    // encloses the range; it is only as much wider as the balls are
+    if (_biv_norm_narrow(t1) && _biv_norm_narrow(t2) &&
+        rho.left_edge() > -RHO_THRESH && rho.right_edge() < RHO_THRESH) {
+        std::pair<Arb, Arb> ends =
+            biv_norm_cdf_unsafe_pair(t1, t2, rho.left_edge(), rho.right_edge());
+        return Arb::join(ends.first, ends.second);
+    }
+
     // snap upper/lower end to +/- 1
     if (rho.right_edge() >= RHO_THRESH) {
         upper = biv_norm_cdf_rho_plus_one(t1.right_edge(), t2.right_edge());
@@ -89,40 +121,708 @@ Arb biv_norm_cdf_rho_plus_one(const Arb &t1, const Arb &t2) {
 Arb biv_norm_cdf_rho_minus_one(const Arb &t1, const Arb &t2) {
     // max(0, 1 - cdf(-t1) - cdf(-t2)) 
     // = max(0, cdf(t1) + cdf(t2) -1 )
-    return Arb::max(0, t1.norm_cdf() + t2.norm_cdf() - 1);
+    // = max(0, cdf(t1) - sf(t2)), which avoids cancellation in the tails
+    return Arb::max(0, t1.norm_cdf() - t2.norm_sf());
+}
+
+// engine selection
+
+static BivNormEngine engine = BIV_NORM_QUADRATURE;
+
+BivNormEngine biv_norm_engine() {
+    return engine;
+}
+
+void biv_norm_set_engine(BivNormEngine e) {
+    // values memoized by another engine would bypass e (e.g. cross-check)
+    if (e != engine) {
+        biv_cache_clear();
+    }
+    engine = e;
+}
+
+static Arb _biv_norm_cdf_engine(const Arb &t1, const Arb &t2, const Arb &rho) {
+    if (engine == BIV_NORM_QUADRATURE) {
+        return biv_norm_cdf_quadrature(t1, t2, rho);
+    }
+
+    Arb owen = biv_norm_cdf_owen_t(t1, t2, rho);
+    if (owen.is_nan()) {
+        return biv_norm_cdf_quadrature(t1, t2, rho);
+    }
+    if (engine == BIV_NORM_OWEN_T) {
+        return owen;
+    }
+
+    // cross check: both enclosures are rigorous, so they must overlap
+    Arb quad = biv_norm_cdf_quadrature(t1, t2, rho);
+    Arb ans;
+    int ok = arb_intersection(ans.t, owen.t, quad.t, Precision::get());
+    if (!ok) {
+        flint_printf("BIV NORM ENGINES DISAGREE\n");
+        t1.println();
+        t2.println();
+        rho.println();
+        owen.println();
+        quad.println();
+    }
+    assert(ok);
+    return ans;
+}
+
+// closed forms
+
+static std::atomic<slong> fast_counts[BIV_NUM_FAST_PATHS];
+
+static int _biv_norm_fast_hit(BivNormFastPath path) {
+    fast_counts[path].fetch_add(1, std::memory_order_relaxed);
+    return 1;
+}
+
+static int _biv_norm_fast(Arb &res, const Arb &t1, const Arb &t2, const Arb &rho) {
+    if (arb_is_zero(t1.t) && arb_is_zero(t2.t)) {
+        // Sheppard
+        res = 0.25 + rho.asin() / (2 * Arb::pi());
+        return _biv_norm_fast_hit(BIV_FAST_SHEPPARD);
+    }
+    if (arb_is_zero(rho.t)) {
+        res = t1.norm_cdf() * t2.norm_cdf();
+        return _biv_norm_fast_hit(BIV_FAST_RHO_ZERO);
+    }
+    // Owen's T only when it is the selected engine; a wide rho is better
+    // left to quadrature: it is not monotone in a
+    if (engine == BIV_NORM_OWEN_T &&
+        arb_equal(t1.t, t2.t) && arb_is_exact(rho.t) && rho > -1 && rho < 1) {
+        // Owen's formula with h = k: both T terms are T(h, (1 - rho)/s)
+        // and beta = 0, which also holds at h = 0 (it is Sheppard there),
+        // so t1 may be any ball
+        Arb a = ((1 - rho) / (1 + rho)).sqrt();
+        Arb ta = owens_t(t1, a);
+        if (!ta.is_nan()) {
+            res = t1.norm_cdf() - 2 * ta;
+            return _biv_norm_fast_hit(BIV_FAST_SYMMETRIC);
+        }
+    }
+    return 0;
+}
+
+slong biv_norm_fast_count(BivNormFastPath path) {
+    return fast_counts[path].load(std::memory_order_relaxed);
+}
+
+void biv_norm_fast_print_stats() {
+    flint_printf("BIV FAST: %wd sheppard, %wd rho = 0, %wd t1 = t2\n",
+                 biv_norm_fast_count(BIV_FAST_SHEPPARD),
+                 biv_norm_fast_count(BIV_FAST_RHO_ZERO),
+                 biv_norm_fast_count(BIV_FAST_SYMMETRIC));
+}
+
+// memoized values: the in-process cache, then the on-disk store
+static int _biv_norm_memo_lookup(Arb &res, const Arb &t1, const Arb &t2, const Arb &rho) {
+    if (biv_cache_lookup(res, t1, t2, rho)) {
+        return 1;
+    }
+    if (biv_store_lookup(res, t1, t2, rho)) {
+        biv_cache_store(t1, t2, rho, res);
+        return 1;
+    }
+    return 0;
+}
+
+static void _biv_norm_memo_store(const Arb &t1, const Arb &t2, const Arb &rho, const Arb &val) {
+    biv_cache_store(t1, t2, rho, val);
+    biv_store_append(t1, t2, rho, val);
 }
 
 Arb biv_norm_cdf_unsafe(const Arb &t1, const Arb &t2, const Arb &rho) {
+    Arb ans;
+    if (_biv_norm_fast(ans, t1, t2, rho)) {
+        return ans;
+    }
+    // the model is cheaper than a lookup, and not worth memoizing
+    if (biv_model_lookup(ans, t1, t2, rho)) {
+        return ans;
+    }
+    if (!_biv_norm_memo_lookup(ans, t1, t2, rho)) {
+        ans = _biv_norm_cdf_engine(t1, t2, rho);
+        _biv_norm_memo_store(t1, t2, rho, ans);
+    }
+    return ans;
+}
+
+// Owen's T engine
+
+// for |a| <= A, Owen's series T1:
+//   T(h, a) = (arctan(a) - sum_j (-1)^j Q_j a^(2j+1)/(2j+1)) / (2 pi)
+// where Q_j = P(X > j) for X ~ Poisson(q), q = h^2/2
+// with w_m = P(X = m), the terms after j = n sum to at most
+//   A^(2n+3) w_(n+2) / ((1 - q/(n+3)) (1 - q A^2/(n+3)))
+// which is <= 4 A^(2n+3) w_(n+2) once n + 3 >= 2 q max(1, A^2), so that
+// both factors are at least 1/2
+// the series holds for any a, but 1 - Q_j cancels and the
+// cancellation is amplified by a^(2j+1), so it is only used for |a| <~ 1
+static Arb _owens_t_series(const Arb &h, const Arb &a) {
+    Arb tol(1);
+    arb_mul_2exp_si(tol.t, tol.t, -Precision::get() - 4);
+
+    Arb q = h.sqr() / 2;
+    Arb w = Arb::exp(-q);
+
+    // 0 <= T(h, |a|) <= exp(-q) arctan(|a|) / (2 pi) < exp(-q)
+    if (w < tol) {
+        Arb ans(0);
+        arb_add_error(ans.t, w.t);
+        return ans;
+    }
+
+    Arb a2 = a.sqr();
+    // q alone matters too: for |a| < 1 the weights only start to fall
+    // by half once n + 3 >= 2 q
+    Arb qa2 = q * Arb::max(1, a2.right_edge());
+    Arb cum = w;
+    Arb apow = a;
+    Arb sum(0);
+
+    for (slong j = 0; ; j++) {
+        Arb term = (1 - cum) * apow / (2*j + 1);
+        sum = (j % 2 == 0) ? std::move(sum) + term : std::move(sum) - term;
+
+        w = w * q / (j + 1);
+        cum = cum + w;
+        apow = apow * a2;
+
+        if (2 * qa2 <= j + 3) {
+            Arb bound = 4 * Arb::abs(apow) * w * q / (j + 2);
+            if (bound < tol) {
+                arb_add_error(sum.t, bound.t);
+                break;
+            }
+        }
+    }
+
+    return (a.atan() - sum) / (2 * Arb::pi());
+}
+
+// for h >= 0 and a > 0:
+//   T(h, a) = (Phi(h) Q(ah) + Phi(ah) Q(h))/2 - T(ah, 1/a)
+// with Q = 1 - Phi
+static Arb _owens_t_reciprocal(const Arb &h, const Arb &a) {
+    Arb ah = a * h;
+    return (h.norm_cdf() * ah.norm_sf() + ah.norm_cdf() * h.norm_sf()) / 2 -
+        _owens_t_series(ah, 1 / a);
+}
+
+Arb owens_t(const Arb &h, const Arb &a) {
+    if (!arb_is_finite(h.t) || !arb_is_finite(a.t)) {
+        return Arb::nan();
+    }
+
+    // T is even in h and odd in a
+    Arb habs = Arb::abs(h);
+
+    if (Arb::abs(a) <= 1.0625) {
+        return _owens_t_series(habs, a);
+    }
+    if (a >= 1) {
+        return _owens_t_reciprocal(habs, a);
+    }
+    if (a <= -1) {
+        return -_owens_t_reciprocal(habs, -a);
+    }
+    if (Arb::abs(a) <= 2) {
+        // straddles 1.0625 or -1.0625: slower, but still valid
+        return _owens_t_series(habs, a);
+    }
+    return Arb::nan();
+}
+
+// T(h, (k - rho h)/(h s)), including h = 0 where it is T(0, +/-inf) = +/-1/4
+static Arb _owens_t_part(const Arb &h, const Arb &k, const Arb &rho, const Arb &s) {
+    if (arb_is_zero(h.t)) {
+        return (k > 0) ? 0.25 : -0.25;
+    }
+    return owens_t(h, (lazy(k) - lazy(rho) * h) / (h * s));
+}
+
+Arb biv_norm_cdf_owen_t(const Arb &t1, const Arb &t2, const Arb &rho) {
+    // Owen (1956):
+    //   Phi2(h, k; rho) = (Phi(h) + Phi(k))/2 - T(h, a_h) - T(k, a_k) - beta
+    // where a_h = (k - rho h)/(h s), a_k = (h - rho k)/(k s), s = sqrt(1 - rho^2)
+    // and beta = 0 if hk > 0, or hk = 0 and h + k >= 0; beta = 1/2 otherwise
+    Arb s2 = 1 - rho.sqr();
+    int z1 = arb_is_zero(t1.t);
+    int z2 = arb_is_zero(t2.t);
+    if (!arb_is_finite(t1.t) || !arb_is_finite(t2.t) || !(s2 > 0) ||
+        (!z1 && arb_contains_zero(t1.t)) ||
+        (!z2 && arb_contains_zero(t2.t))) {
+        return Arb::nan();
+    }
+
+    if (z1 && z2) {
+        // Sheppard
+        return 0.25 + rho.asin() / (2 * Arb::pi());
+    }
+
+    Arb s = s2.sqrt();
+    Arb ans = (t1.norm_cdf() + t2.norm_cdf()) / 2 -
+        _owens_t_part(t1, t2, rho, s) - _owens_t_part(t2, t1, rho, s);
+
+    if ((z1 || z2) ? (t1 + t2 < 0) : (t1 * t2 < 0)) {
+        ans = std::move(ans) - 0.5;
+    }
+    return ans;
+}
+
+// integrator statistics
+
+class _BivIntegStats {
+public:
+    std::atomic<slong> counts[BIV_INTEG_NUM_STATS] = {};
+    std::atomic<slong> latency[BIV_INTEG_HIST_SIZE] = {};
+    std::atomic<slong> radius[BIV_INTEG_HIST_SIZE] = {};
+    // slowest call so far, written under integ_mutex
+    slong worst_ns = -1;
+    Arb worst_t1, worst_t2, worst_a, worst_b;
+};
+
+static std::mutex integ_mutex;
+static std::vector<_BivIntegStats*> integ_threads;
+// threads that have exited
+static _BivIntegStats integ_retired;
+
+// caller holds integ_mutex
+static void _biv_integ_merge(_BivIntegStats &dst, const _BivIntegStats &src) {
+    for (int i = 0; i < BIV_INTEG_NUM_STATS; i++) {
+        dst.counts[i] += src.counts[i].load(std::memory_order_relaxed);
+    }
+    for (int k = 0; k < BIV_INTEG_HIST_SIZE; k++) {
+        dst.latency[k] += src.latency[k].load(std::memory_order_relaxed);
+        dst.radius[k] += src.radius[k].load(std::memory_order_relaxed);
+    }
+    if (src.worst_ns > dst.worst_ns) {
+        dst.worst_ns = src.worst_ns;
+        dst.worst_t1 = src.worst_t1;
+        dst.worst_t2 = src.worst_t2;
+        dst.worst_a = src.worst_a;
+        dst.worst_b = src.worst_b;
+    }
+}
+
+class _BivIntegThread {
+public:
+    _BivIntegThread() {
+        std::lock_guard<std::mutex> lock(integ_mutex);
+        integ_threads.push_back(&stats);
+    }
+
+    ~_BivIntegThread() {
+        std::lock_guard<std::mutex> lock(integ_mutex);
+        _biv_integ_merge(integ_retired, stats);
+        integ_threads.erase(std::find(integ_threads.begin(), integ_threads.end(), &stats));
+    }
+
+    _BivIntegThread(const _BivIntegThread&) = delete;
+    _BivIntegThread& operator=(const _BivIntegThread&) = delete;
+
+    _BivIntegStats stats;
+};
+
+static thread_local _BivIntegThread integ_thread;
+
+// only this thread writes its counters, so relaxed is enough
+static void _biv_integ_add(BivIntegStat stat, slong n = 1) {
+    integ_thread.stats.counts[stat].fetch_add(n, std::memory_order_relaxed);
+}
+
+static int _biv_integ_bucket(slong k) {
+    return (int) std::max<slong>(0, std::min<slong>(k, BIV_INTEG_HIST_SIZE - 1));
+}
+
+static void _biv_integ_record(const Arb &t1, const Arb &t2, const Arb &a, const Arb &b,
+                              const Arb &res, slong ns) {
+    _BivIntegStats& st = integ_thread.stats;
+    st.counts[BIV_INTEG_CALLS].fetch_add(1, std::memory_order_relaxed);
+    st.counts[BIV_INTEG_NANOS].fetch_add(ns, std::memory_order_relaxed);
+    st.latency[_biv_integ_bucket(ns > 0 ? FLINT_BIT_COUNT((ulong) ns) - 1 : 0)]
+        .fetch_add(1, std::memory_order_relaxed);
+
+    // the radius is in [2^(e-1), 2^e) for the mag exponent e
+    const mag_struct* rad = arb_radref(res.t);
+    slong k;
+    if (!arb_is_finite(res.t)) {
+        k = BIV_INTEG_HIST_SIZE - 1;
+    }
+    else if (mag_is_zero(rad)) {
+        k = 0;
+    }
+    else {
+        k = Precision::get() + fmpz_get_si(MAG_EXPREF(rad));
+    }
+    st.radius[_biv_integ_bucket(k)].fetch_add(1, std::memory_order_relaxed);
+
+    if (ns > st.worst_ns) {
+        std::lock_guard<std::mutex> lock(integ_mutex);
+        st.worst_ns = ns;
+        st.worst_t1 = t1;
+        st.worst_t2 = t2;
+        st.worst_a = a;
+        st.worst_b = b;
+    }
+}
+
+// all threads, live and exited
+static void _biv_integ_total(_BivIntegStats &total) {
+    std::lock_guard<std::mutex> lock(integ_mutex);
+    _biv_integ_merge(total, integ_retired);
+    for (const _BivIntegStats* st : integ_threads) {
+        _biv_integ_merge(total, *st);
+    }
+}
+
+slong biv_norm_integ_count(BivIntegStat stat) {
+    _BivIntegStats total;
+    _biv_integ_total(total);
+    return total.counts[stat].load();
+}
+
+void biv_norm_integ_latency_hist(slong *hist) {
+    _BivIntegStats total;
+    _biv_integ_total(total);
+    for (int k = 0; k < BIV_INTEG_HIST_SIZE; k++) {
+        hist[k] = total.latency[k].load();
+    }
+}
+
+void biv_norm_integ_radius_hist(slong *hist) {
+    _BivIntegStats total;
+    _biv_integ_total(total);
+    for (int k = 0; k < BIV_INTEG_HIST_SIZE; k++) {
+        hist[k] = total.radius[k].load();
+    }
+}
+
+static void _biv_integ_print_hist(const char *name, const std::atomic<slong> *hist) {
+    flint_printf("BIV INTEG %s:", name);
+    for (int k = 0; k < BIV_INTEG_HIST_SIZE; k++) {
+        slong n = hist[k].load();
+        if (n != 0) {
+            flint_printf(" %d:%wd", k, n);
+        }
+    }
+    flint_printf("\n");
+}
+
+void biv_norm_integ_print_stats() {
+    _BivIntegStats total;
+    _biv_integ_total(total);
+    const std::atomic<slong>* c = total.counts;
+    flint_printf("BIV INTEG: %wd calls in %wd ms, "
+                 "gl %wd pieces (%wd rejected, %wd splits, %wd nodes), "
+                 "acb %wd calls (%wd boxes, %wd points, %wd hit a limit), "
+                 "%wd paired\n",
+                 c[BIV_INTEG_CALLS].load(), c[BIV_INTEG_NANOS].load() / 1000000,
+                 c[BIV_INTEG_GL_PIECES].load(), c[BIV_INTEG_GL_REJECTS].load(),
+                 c[BIV_INTEG_GL_SPLITS].load(), c[BIV_INTEG_GL_NODES].load(),
+                 c[BIV_INTEG_ACB_CALLS].load(), c[BIV_INTEG_ACB_BOXES].load(),
+                 c[BIV_INTEG_ACB_POINTS].load(), c[BIV_INTEG_ACB_LIMITS].load(),
+                 c[BIV_INTEG_PAIRED].load());
+    _biv_integ_print_hist("LATENCY", total.latency);
+    _biv_integ_print_hist("RADIUS", total.radius);
+    if (total.worst_ns >= 0) {
+        flint_printf("BIV INTEG SLOWEST: %wd us\n", total.worst_ns / 1000);
+        total.worst_t1.println();
+        total.worst_t2.println();
+        total.worst_a.println();
+        total.worst_b.println();
+    }
+}
+
+// quadrature engine
+
+// int_0^rho d/drho for the last few (t1, t2, rho, precision) of this thread;
+// bisection children share an endpoint with their parent, so the prefix
+// at that endpoint is usually here already
+#define PREFIX_CACHE_SIZE 16
+
+class _PrefixEntry {
+public:
+    Arb t1, t2, rho, val;
+    slong prec = 0;
+};
+
+static thread_local _PrefixEntry prefix_cache[PREFIX_CACHE_SIZE];
+static thread_local int prefix_next = 0;
+
+static int _prefix_lookup(Arb &res, const Arb &t1, const Arb &t2, const Arb &rho) {
+    slong prec = Precision::get();
+    for (const _PrefixEntry& e : prefix_cache) {
+        if (e.prec == prec && arb_equal(e.rho.t, rho.t) &&
+            arb_equal(e.t1.t, t1.t) && arb_equal(e.t2.t, t2.t)) {
+            res = e.val;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void _prefix_store(const Arb &t1, const Arb &t2, const Arb &rho, const Arb &val) {
+    _PrefixEntry& e = prefix_cache[prefix_next];
+    prefix_next = (prefix_next + 1) % PREFIX_CACHE_SIZE;
+    e.t1 = t1;
+    e.t2 = t2;
+    e.rho = rho;
+    e.val = val;
+    e.prec = Precision::get();
+}
+
+static Arb _biv_norm_prefix(const Arb &t1, const Arb &t2, const Arb &rho) {
+    Arb ans;
+    if (!_prefix_lookup(ans, t1, t2, rho)) {
+        ans = biv_norm_cdf_d_rho_integral(t1, t2, 0, rho);
+        _prefix_store(t1, t2, rho, ans);
+    }
+    return ans;
+}
+
+Arb biv_norm_cdf_quadrature(const Arb &t1, const Arb &t2, const Arb &rho) {
     // special handling when rho is close to +/-1 is NOT implemented...
+    Arb ans = _biv_norm_prefix(t1, t2, rho);
+
+    // Drezner & Wesolowsky eq.6 with additive correction
+    return ans + t1.norm_cdf() * t2.norm_cdf();
+}
+
+static std::pair<Arb, Arb> _biv_norm_cdf_unsafe_pair(const Arb &t1, const Arb &t2,
+                                                     const Arb &lo, const Arb &hi) {
+    Arb base = t1.norm_cdf() * t2.norm_cdf();
 
+    // if [lo, hi] contains 0 the two prefixes do not overlap
+    if (!(lo >= 0) && !(hi <= 0)) {
+        return std::make_pair(_biv_norm_prefix(t1, t2, lo) + base,
+                              _biv_norm_prefix(t1, t2, hi) + base);
+    }
+
+    // otherwise extend the prefix of the endpoint nearer 0
+    int up = (lo >= 0);
+    const Arb& near = up ? lo : hi;
+    const Arb& far = up ? hi : lo;
+    Arb pnear = _biv_norm_prefix(t1, t2, near);
+    Arb pfar;
+    if (!_prefix_lookup(pfar, t1, t2, far)) {
+        pfar = pnear + biv_norm_cdf_d_rho_integral(t1, t2, near, far);
+        _biv_integ_add(BIV_INTEG_PAIRED);
+        _prefix_store(t1, t2, far, pfar);
+    }
+    return up ? std::make_pair(pnear + base, pfar + base) :
+        std::make_pair(pfar + base, pnear + base);
+}
+
+std::pair<Arb, Arb> biv_norm_cdf_unsafe_pair(const Arb &t1, const Arb &t2,
+                                             const Arb &lo, const Arb &hi) {
+    Arb clo, chi;
+    int fast_lo = _biv_norm_fast(clo, t1, t2, lo);
+    int fast_hi = _biv_norm_fast(chi, t1, t2, hi);
+    if (fast_lo || fast_hi) {
+        return std::make_pair(fast_lo ? clo : biv_norm_cdf_unsafe(t1, t2, lo),
+                              fast_hi ? chi : biv_norm_cdf_unsafe(t1, t2, hi));
+    }
+    if (biv_model_lookup(clo, t1, t2, lo) && biv_model_lookup(chi, t1, t2, hi)) {
+        return std::make_pair(clo, chi);
+    }
+
+    int hit_lo = _biv_norm_memo_lookup(clo, t1, t2, lo);
+    int hit_hi = _biv_norm_memo_lookup(chi, t1, t2, hi);
+    if (hit_lo && hit_hi) {
+        return std::make_pair(clo, chi);
+    }
+
+    std::pair<Arb, Arb> ans;
+    if (engine != BIV_NORM_QUADRATURE || hit_lo || hit_hi) {
+        ans.first = hit_lo ? clo : _biv_norm_cdf_engine(t1, t2, lo);
+        ans.second = hit_hi ? chi : _biv_norm_cdf_engine(t1, t2, hi);
+    }
+    else {
+        ans = _biv_norm_cdf_unsafe_pair(t1, t2, lo, hi);
+    }
+    if (!hit_lo) {
+        _biv_norm_memo_store(t1, t2, lo, ans.first);
+    }
+    if (!hit_hi) {
+        _biv_norm_memo_store(t1, t2, hi, ans.second);
+    }
+    return ans;
+}
+
+// d/drho with s = t1^2 + t2^2 and p = t1 t2 already formed
+static Arb _biv_norm_d_rho(const Arb &s, const Arb &p, const Arb &rho) {
+    Arb a = 1 - rho.sqr();
+    Arb b = s - 2*lazy(rho)*p;
+    return Arb::exp(-0.5*lazy(b)/a - Arb::log_2pi()) / a.sqrt();
+}
+
+// Gauss-Legendre nodes and weights on [-1, 1], cached per thread
+class _GaussLegendreRule {
+public:
+    _GaussLegendreRule(slong prec, slong n) : prec(prec), n(n) {
+        x = _arb_vec_init(n);
+        w = _arb_vec_init(n);
+        // roots come in +/- pairs, largest first
+        for (slong k = 0; k < (n + 1) / 2; k++) {
+            arb_hypgeom_legendre_p_ui_root(x + k, w + k, n, k, prec);
+            arb_neg(x + n - 1 - k, x + k);
+            arb_set(w + n - 1 - k, w + k);
+        }
+    }
+
+    ~_GaussLegendreRule() {
+        _arb_vec_clear(x, n);
+        _arb_vec_clear(w, n);
+    }
+
+    _GaussLegendreRule(const _GaussLegendreRule&) = delete;
+    _GaussLegendreRule& operator=(const _GaussLegendreRule&) = delete;
+
+    slong prec, n;
+    arb_ptr x, w;
+};
+
+static thread_local std::deque<_GaussLegendreRule> gl_rules;
+
+// enough nodes that the remainder below is about 2^-prec when M (b-a) ~ 1
+static const _GaussLegendreRule& _gauss_legendre_rule(slong prec) {
+    slong n = prec / 2 + 8;
+    for (const _GaussLegendreRule& rule : gl_rules) {
+        if (rule.prec == prec && rule.n == n) {
+            return rule;
+        }
+    }
+    return gl_rules.emplace_back(prec, n);
+}
+
+// int_a^b d/drho on the real line, or 0 if the remainder is not below tol
+// if f is analytic with |f| <= M inside the Bernstein ellipse with
+// parameter r around [a, b], the n-point rule is off by at most
+//   (b-a)/2 * 64/15 * M r^(-2n) / (r^2 - 1)
+// (Trefethen, Is Gauss quadrature better than Clenshaw-Curtis?, Thm 4.5)
+// with r = 2 the ellipse has semi-axes 5/4 and 3/4 of (b-a)/2, and M is
+// taken from one Acb evaluation over the box containing it
+static int _biv_norm_gl_piece(Arb &res, const Arb &t1, const Arb &t2,
+                              const Arb &a, const Arb &b, const Arb &tol) {
+    slong prec = Precision::get();
+    const _GaussLegendreRule& rule = _gauss_legendre_rule(prec);
+    _biv_integ_add(BIV_INTEG_GL_PIECES);
+
+    Arb c = (lazy(a) + b) / 2;
+    Arb l = (lazy(b) - a) / 2;
+
+    Arb re = c, im(0);
+    arb_add_error(re.t, Arb(1.25 * lazy(l)).t);
+    arb_add_error(im.t, Arb(0.75 * lazy(l)).t);
+    Acb f = biv_norm_cdf_d_rho_analytic(t1, t2, Acb(re, im), 1);
+    if (!acb_is_finite(f.t)) {
+        _biv_integ_add(BIV_INTEG_GL_REJECTS);
+        return 0;
+    }
+
+    mag_t m;
+    mag_init(m);
+    acb_get_mag(m, f.t);
+    Arb err;
+    arf_set_mag(arb_midref(err.t), m);
+    mag_clear(m);
+    err = Arb::abs(l) * err * 64 / 45;
+    arb_mul_2exp_si(err.t, err.t, -2 * rule.n);
+    if (!(err < tol)) {
+        _biv_integ_add(BIV_INTEG_GL_REJECTS);
+        return 0;
+    }
+
+    // the integrand is real here: no complex arithmetic per node
+    Arb s = t1.sqr() + t2.sqr();
+    Arb p = t1 * t2;
+    Arb sum(0);
+    for (slong k = 0; k < rule.n; k++) {
+        Arb rho = c;
+        arb_addmul(rho.t, l.t, rule.x + k, prec);
+        Arb y = _biv_norm_d_rho(s, p, rho);
+        arb_addmul(sum.t, rule.w + k, y.t, prec);
+    }
+    _biv_integ_add(BIV_INTEG_GL_NODES, rule.n);
+
+    res = sum * l;
+    arb_add_error(res.t, err.t);
+    return 1;
+}
+
+// acb_calc_integrate over [a, b], used where Gauss-Legendre cannot certify
+static Arb _biv_norm_acb_integral(const Arb &t1, const Arb &t2, const Arb &a, const Arb &b) {
     acb_calc_integrate_opt_t options;
     acb_calc_integrate_opt_init(options);
 
     Acb ct1(t1), ct2(t2);
     acb_t param[2] = {(*ct1.t), (*ct2.t)};
 
+    slong goal = Precision::get();
+    slong prec = Precision::get();
+
     mag_t tol; mag_init(tol);
-    mag_set_ui_2exp_si(tol, 1, -GLOBAL_PRECISION);
+    mag_set_ui_2exp_si(tol, 1, -prec);
 
-    slong goal = GLOBAL_PRECISION;
-    slong prec = GLOBAL_PRECISION;
+    Acb ca(a), cb(b), res;
 
-    Acb a(0), b(rho), res;
+    _biv_integ_add(BIV_INTEG_ACB_CALLS);
+    int status = acb_calc_integrate(res.t, _biv_norm_cdf_helper, param, ca.t, cb.t,
+                                    goal, tol, options, prec);
+    if (status != ARB_CALC_SUCCESS) {
+        _biv_integ_add(BIV_INTEG_ACB_LIMITS);
+    }
 
-    acb_calc_integrate(res.t, _biv_norm_cdf_helper, param, a.t, b.t, goal, tol, options, prec);
+    mag_clear(tol);
 
     assert(res.is_real());
 
-    Arb ans = res.real();
-    
-    // Drezner & Wesolowsky eq.6 with additive correction
-    return ans + t1.norm_cdf() * t2.norm_cdf(); 
+    return res.real();
+}
+
+// near rho = +/-1 the ellipse must shrink, so halve [a, b] up to this depth
+#define GL_MAX_DEPTH 8
+
+static Arb _biv_norm_gl(const Arb &t1, const Arb &t2, const Arb &a, const Arb &b,
+                        const Arb &tol, int depth) {
+    Arb ans;
+    if (_biv_norm_gl_piece(ans, t1, t2, a, b, tol)) {
+        return ans;
+    }
+    if (depth == GL_MAX_DEPTH) {
+        return _biv_norm_acb_integral(t1, t2, a, b);
+    }
+
+    // exact midpoint, so the two halves meet
+    _biv_integ_add(BIV_INTEG_GL_SPLITS);
+    Arb m;
+    arb_add(m.t, a.t, b.t, ARF_PREC_EXACT);
+    arb_mul_2exp_si(m.t, m.t, -1);
+    Arb half_tol = tol / 2;
+    return _biv_norm_gl(t1, t2, a, m, half_tol, depth + 1) +
+        _biv_norm_gl(t1, t2, m, b, half_tol, depth + 1);
+}
+
+Arb biv_norm_cdf_d_rho_integral(const Arb &t1, const Arb &t2, const Arb &a, const Arb &b) {
+    Arb tol(1);
+    arb_mul_2exp_si(tol.t, tol.t, -Precision::get());
+
+    auto start = std::chrono::steady_clock::now();
+    Arb ans = _biv_norm_gl(t1, t2, a, b, tol, 0);
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    _biv_integ_record(t1, t2, a, b, ans, ns);
+    return ans;
 }
 
 Arb biv_norm_cdf_d_t1(const Arb &t1, const Arb &t2, const Arb &rho) {
     // formula is norm_pdf(t1) * norm_cdf((t2 - rho * t1) / sqrt (1 - rho*rho))
     Arb u = t1.norm_pdf();
-    Arb v = (t2 - rho * t1) / Arb::sqrt(1 - rho.sqr());
+    Arb v = (lazy(t2) - lazy(rho) * t1) / Arb::sqrt(1 - rho.sqr());
     return u*v.norm_cdf(); 
 }
 
@@ -132,15 +832,60 @@ Arb biv_norm_cdf_d_t2(const Arb &t1, const Arb &t2, const Arb &rho) {
 
 Arb biv_norm_cdf_d_rho(const Arb &t1, const Arb &t2, const Arb &rho) {
     // 1/(2*pi*sqrt(1-rho*rho)) * exp(- (t1*t1 - 2*rho*t1*t2 + t2*t2)/ (2*(1-rho*rho)))
-    Arb a = 1 - rho.sqr();
-    Arb b = t1.sqr() + t2.sqr() - 2*rho*t1*t2;
-    return Arb::exp((-1.0/2.0)*b/a) / (2*Arb::pi()*a.sqrt());
+    // computed as exp(-b/(2a) - log(2*pi)) / sqrt(a)
+    return _biv_norm_d_rho(t1.sqr() + t2.sqr(), t1 * t2, rho);
+}
+
+Gradient3 biv_norm_cdf_grad(const Arb &t1, const Arb &t2, const Arb &rho) {
+    // d/dt1 = pdf(t1) cdf(u), d/dt2 = pdf(t2) cdf(v) with s = sqrt(1 - rho^2),
+    // u = (t2 - rho t1)/s, v = (t1 - rho t2)/s; d/drho is the density
+    Arb s = Arb::sqrt(1 - rho.sqr());
+    Arb u = (lazy(t2) - lazy(rho) * t1) / s;
+    Arb v = (lazy(t1) - lazy(rho) * t2) / s;
+
+    Gradient3 g;
+    g.value = biv_norm_cdf(t1, t2, rho);
+    g.x = t1.norm_pdf() * u.norm_cdf();
+    g.y = t2.norm_pdf() * v.norm_cdf();
+    g.z = _biv_norm_d_rho(t1.sqr() + t2.sqr(), t1 * t2, rho);
+    return g;
+}
+
+Hessian3 biv_norm_cdf_hessian(const Arb &t1, const Arb &t2, const Arb &rho) {
+    // with s = sqrt(1 - rho^2), u = (t2 - rho t1)/s, v = (t1 - rho t2)/s,
+    // q = t1^2 - 2 rho t1 t2 + t2^2 and the density f = d/drho:
+    //   d2/dt1^2    = -t1 pdf(t1) cdf(u) - rho/s pdf(t1) pdf(u)
+    //   d2/dt1dt2   = pdf(t1) pdf(u)/s = f
+    //   d2/dt1drho  = -f (t1 - rho t2)/s^2
+    //   d2/drho^2   = f (rho + t1 t2 - rho q/s^2)/s^2
+    // and the same with t1, t2 swapped
+    Arb s2 = 1 - rho.sqr();
+    Arb s = s2.sqrt();
+    Arb u = (lazy(t2) - lazy(rho) * t1) / s;
+    Arb v = (lazy(t1) - lazy(rho) * t2) / s;
+    Arb p1 = t1.norm_pdf();
+    Arb p2 = t2.norm_pdf();
+    Arb pu = u.norm_pdf();
+    Arb pv = v.norm_pdf();
+    Arb r = rho / s;
+    Arb f = p1 * pu / s;
+    Arb q = t1.sqr() + t2.sqr() - 2*lazy(rho)*t1*t2;
+
+    Hessian3 h;
+    h.xx = -(lazy(t1) * p1 * u.norm_cdf() + lazy(r) * p1 * pu);
+    h.yy = -(lazy(t2) * p2 * v.norm_cdf() + lazy(r) * p2 * pv);
+    h.xy = f;
+    h.xz = -f * v / s;
+    h.yz = -f * u / s;
+    h.zz = f * (rho + lazy(t1) * t2 - lazy(rho) * q / s2) / s2;
+    return h;
 }
 
 int _biv_norm_cdf_helper(acb_ptr res, const acb_t rho, void * param, slong order, slong prec) {
     // documentation says these should never be tripped...
     assert(order == 0 || order == 1);
-    assert(prec <= GLOBAL_PRECISION);
+    assert(prec <= Precision::get());
+    _biv_integ_add(order == 0 ? BIV_INTEG_ACB_POINTS : BIV_INTEG_ACB_BOXES);
 
     acb_t* param_acb_t = (acb_t*) param;
     Acb t1(param_acb_t[0]), t2(param_acb_t[1]);
@@ -154,7 +899,8 @@ int _biv_norm_cdf_helper(acb_ptr res, const acb_t rho, void * param, slong order
 
 Acb biv_norm_cdf_d_rho_analytic(const Acb &t1, const Acb &t2, const Acb &rho, int analytic) {
     // 1/(2*pi*sqrt(1-rho*rho)) * exp(- (t1*t1 - 2*rho*t1*t2 + t2*t2)/ (2*(1-rho*rho)))
+    // computed as exp(-b/(2a) - log(2*pi)) / sqrt(a)
     Acb a = 1 - rho.sqr();
     Acb b = t1.sqr() + t2.sqr() - 2*rho*t1*t2;
-    return Acb::exp((-1.0/2.0)*b/a) / (2*Acb::pi()*a.sqrt_analytic(analytic));
+    return Acb::exp((-1.0/2.0)*b/a - Arb::log_2pi()) / a.sqrt_analytic(analytic);
 }
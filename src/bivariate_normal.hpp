@@ -9,6 +9,7 @@
 
 #include "arb_wrapper.hpp"
 #include "acb_wrapper.hpp"
+#include <utility>
 
 // given a bivariate normal with covariance matrix (1 rho; rho 1)
 // find the probability that the sample (X,Y) satisfies
@@ -23,6 +24,79 @@ Arb biv_norm_cdf_norm_thresh(const Arb &t1, const Arb &t2, const Arb &rho);
 
 Arb biv_norm_cdf(const Arb &t1, const Arb &t2, const Arb &rho);
 Arb biv_norm_cdf_unsafe(const Arb &t1, const Arb &t2, const Arb &rho);
+// biv_norm_cdf_unsafe at rho = lo and at rho = hi; with the quadrature
+// engine the second value only integrates [lo, hi] on top of the first
+std::pair<Arb, Arb> biv_norm_cdf_unsafe_pair(const Arb &t1, const Arb &t2,
+                                             const Arb &lo, const Arb &hi);
+
+// engines behind biv_norm_cdf_unsafe, chosen at runtime (--biv-engine=)
+enum BivNormEngine {
+    BIV_NORM_QUADRATURE,   // integral over d/drho (default)
+    BIV_NORM_OWEN_T,       // Owen's T series, quadrature where it does not apply
+    BIV_NORM_CROSS_CHECK   // both, intersected; aborts if they are disjoint
+};
+
+// bumped by any change that can alter the enclosures biv_norm_cdf_unsafe
+// returns; an on-disk store written by another revision is not used
+#define BIV_NORM_REVISION 1
+
+// closed forms biv_norm_cdf_unsafe tries before any engine:
+// Sheppard's formula at t1 = t2 = 0, Phi(t1) Phi(t2) at rho = 0, and
+// Phi(t) - 2 T(t, sqrt((1 - rho)/(1 + rho))) when t1 and t2 are the same ball
+// and rho is exact (only with --biv-engine=owen-t)
+enum BivNormFastPath {
+    BIV_FAST_SHEPPARD,
+    BIV_FAST_RHO_ZERO,
+    BIV_FAST_SYMMETRIC,
+    BIV_NUM_FAST_PATHS
+};
+
+slong biv_norm_fast_count(BivNormFastPath path);
+void biv_norm_fast_print_stats();
+
+// statistics of biv_norm_cdf_d_rho_integral, the rho integral behind the
+// quadrature engine; each thread keeps its own and they are summed on export
+enum BivIntegStat {
+    BIV_INTEG_CALLS,        // calls of biv_norm_cdf_d_rho_integral
+    BIV_INTEG_NANOS,        // time spent in them
+    BIV_INTEG_GL_PIECES,    // Gauss-Legendre pieces tried
+    BIV_INTEG_GL_REJECTS,   // pieces whose remainder bound was not below tol
+    BIV_INTEG_GL_SPLITS,    // rejected pieces halved
+    BIV_INTEG_GL_NODES,     // real integrand evaluations at the nodes
+    BIV_INTEG_ACB_CALLS,    // pieces left to acb_calc_integrate
+    BIV_INTEG_ACB_BOXES,    // its integrand bounds on a complex box (one per subinterval)
+    BIV_INTEG_ACB_POINTS,   // its integrand evaluations at the nodes
+    BIV_INTEG_ACB_LIMITS,   // its calls that hit eval_limit or depth_limit
+    BIV_INTEG_PAIRED,       // calls that only extended a prefix integral
+    BIV_INTEG_NUM_STATS
+};
+
+// histograms of the calls: latency bucket k is [2^k, 2^(k+1)) ns;
+// radius bucket 0 is at most 2^-prec, bucket k is (2^(k-1-prec), 2^(k-prec)]
+// and the last one also holds anything wider
+#define BIV_INTEG_HIST_SIZE 64
+
+slong biv_norm_integ_count(BivIntegStat stat);
+void biv_norm_integ_latency_hist(slong *hist);
+void biv_norm_integ_radius_hist(slong *hist);
+// totals, nonzero buckets as bucket:count, and the arguments of the slowest call
+void biv_norm_integ_print_stats();
+
+BivNormEngine biv_norm_engine();
+void biv_norm_set_engine(BivNormEngine engine);
+
+Arb biv_norm_cdf_quadrature(const Arb &t1, const Arb &t2, const Arb &rho);
+// int_a^b d/drho biv_norm_cdf(t1, t2, r) dr for -1 < a, b < 1
+// real Gauss-Legendre with a Bernstein ellipse remainder, bisecting
+// towards +/-1; acb_calc_integrate on pieces it still cannot certify
+Arb biv_norm_cdf_d_rho_integral(const Arb &t1, const Arb &t2, const Arb &a, const Arb &b);
+// NaN when t1 or t2 contains 0 without being exactly 0, or |rho| < 1 fails
+Arb biv_norm_cdf_owen_t(const Arb &t1, const Arb &t2, const Arb &rho);
+
+// Owen's T function
+// T(h, a) = 1/(2 pi) int_0^a exp(-h^2 (1 + x^2)/2) / (1 + x^2) dx
+// NaN when a is a wide ball around +/-1 or straddles 0 with |a| > 2
+Arb owens_t(const Arb &h, const Arb &a);
 Arb biv_norm_cdf_rho_plus_one(const Arb &t1, const Arb &t2);
 Arb biv_norm_cdf_rho_minus_one(const Arb &t1, const Arb &t2);
 
@@ -31,7 +105,23 @@ Arb biv_norm_cdf_d_t1(const Arb &t1, const Arb &t2, const Arb &rho);
 Arb biv_norm_cdf_d_t2(const Arb &t1, const Arb &t2, const Arb &rho);
 Arb biv_norm_cdf_d_rho(const Arb &t1, const Arb &t2, const Arb &rho);
 
-// might add second order partials later
+// value and first order partials of a function of (x, y, z)
+class Gradient3 {
+public:
+    Arb value, x, y, z;
+};
+
+// biv_norm_cdf and its three partials, sharing sqrt(1 - rho^2) and the pdfs
+Gradient3 biv_norm_cdf_grad(const Arb &t1, const Arb &t2, const Arb &rho);
+
+// second order partials of a function of (x, y, z)
+class Hessian3 {
+public:
+    Arb xx, xy, xz, yy, yz, zz;
+};
+
+// all six second partials in (t1, t2, rho), sharing the density
+Hessian3 biv_norm_cdf_hessian(const Arb &t1, const Arb &t2, const Arb &rho);
 
 // helper function for biv_norm_cdf
 int _biv_norm_cdf_helper(acb_ptr res, const acb_t rho, void * param, slong order, slong prec);
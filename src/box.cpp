@@ -0,0 +1,152 @@
+/*
+  Copyright (c) 2022-23 Joshua Brakensiek, Neng Huang, Aaron Potechin and Uri Zwick
+
+  This code is licensed under the MIT License.
+*/
+
+#include "box.hpp"
+#include <cassert>
+#include <string>
+#include <utility>
+
+Box::Box(std::initializer_list<Arb> coords) : x(coords) {}
+
+slong Box::dim() const {
+    return x.size();
+}
+
+Arb& Box::operator[](slong i) {
+    assert(0 <= i && i < dim());
+    return x[i];
+}
+
+const Arb& Box::operator[](slong i) const {
+    assert(0 <= i && i < dim());
+    return x[i];
+}
+
+slong Box::widest() const {
+    assert(dim() > 0);
+    slong best = 0;
+    Arb rbest = x[0].rad();
+    for (slong i = 1; i < dim(); i++) {
+        Arb r = x[i].rad();
+        // strict, so ties go to the earlier axis
+        if (r > rbest) {
+            best = i;
+            rbest = std::move(r);
+        }
+    }
+    return best;
+}
+
+Box Box::left_half(slong i) const {
+    Box b = *this;
+    b[i] = x[i].left_half();
+    return b;
+}
+
+Box Box::right_half(slong i) const {
+    Box b = *this;
+    b[i] = x[i].right_half();
+    return b;
+}
+
+Arb Box::vol() const {
+    Arb v(1);
+    for (const Arb& c : x) {
+        v = std::move(v) * c.rad();
+    }
+    return v;
+}
+
+void Box::println() const {
+    for (const Arb& c : x) {
+        c.println();
+    }
+}
+
+Cell::Cell(slong dim) : d(dim) {
+    assert(0 < dim && dim <= CELL_MAX_DIM);
+    for (slong i = 0; i < dim; i++) {
+        node[i] = 1;
+    }
+}
+
+slong Cell::dim() const {
+    return d;
+}
+
+slong Cell::level(slong i) const {
+    assert(0 <= i && i < d);
+    return FLINT_BIT_COUNT(node[i]) - 1;
+}
+
+ulong Cell::index(slong i) const {
+    return node[i] - (UWORD(1) << level(i));
+}
+
+slong Cell::depth() const {
+    slong ans = 0;
+    for (slong i = 0; i < d; i++) {
+        ans += level(i);
+    }
+    return ans;
+}
+
+Cell Cell::left_half(slong i) const {
+    assert(level(i) < CELL_MAX_LEVEL);
+    Cell c = *this;
+    c.node[i] = 2 * node[i];
+    return c;
+}
+
+Cell Cell::right_half(slong i) const {
+    assert(level(i) < CELL_MAX_LEVEL);
+    Cell c = *this;
+    c.node[i] = 2 * node[i] + 1;
+    return c;
+}
+
+Box Cell::box(const Box &root) const {
+    assert(root.dim() == d);
+    Box b = root;
+    for (slong i = 0; i < d; i++) {
+        if (node[i] != 1) {
+            b[i] = root[i].dyadic_piece(level(i), index(i));
+        }
+    }
+    return b;
+}
+
+int Cell::operator==(const Cell &c) const {
+    if (d != c.d) {
+        return 0;
+    }
+    for (slong i = 0; i < d; i++) {
+        if (node[i] != c.node[i]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+ulong Cell::hash() const {
+    // FNV-1a over the words
+    ulong h = 14695981039346656037UL;
+    for (slong i = 0; i < d; i++) {
+        h = (h ^ node[i]) * 1099511628211UL;
+    }
+    return h;
+}
+
+std::string Cell::str() const {
+    std::string s;
+    for (slong i = 0; i < d; i++) {
+        if (i > 0) {
+            s += ' ';
+        }
+        s += std::to_string(level(i)) + ':' + std::to_string(index(i));
+    }
+    return s;
+}
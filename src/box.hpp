@@ -0,0 +1,75 @@
+/*
+  Copyright (c) 2022-23 Joshua Brakensiek, Neng Huang, Aaron Potechin and Uri Zwick
+
+  This code is licensed under the MIT License.
+*/
+
+#ifndef BOX_HPP
+#define BOX_HPP
+
+#include "arb_wrapper.hpp"
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+// An axis-aligned box: one ball per coordinate, e.g. Box{b1, b2, rho}.
+class Box {
+public:
+    Box() = default;
+    Box(std::initializer_list<Arb> coords);
+
+    slong dim() const;
+    Arb& operator[](slong i);
+    const Arb& operator[](slong i) const;
+
+    // axis with the largest radius, the first one on ties
+    slong widest() const;
+    // the box with coordinate i replaced by its left/right half
+    Box left_half(slong i) const;
+    Box right_half(slong i) const;
+    // product of the radii
+    Arb vol() const;
+
+    void println() const;
+
+private:
+    std::vector<Arb> x;
+};
+
+#define CELL_MAX_DIM 4
+#define CELL_MAX_LEVEL 62
+
+// A box of the bisection tree below a root box, in integers: along axis
+// i it is piece index(i) of the 2^level(i) equal pieces of root[i]. Each
+// axis takes one word, 2^level + index, so a cell is a few bytes, is
+// compared and hashed exactly and can be written out as it is.
+class Cell {
+public:
+    Cell() = default;
+    // the whole root box
+    explicit Cell(slong dim);
+
+    slong dim() const;
+    slong level(slong i) const;
+    ulong index(slong i) const;
+    // the number of splits that led here
+    slong depth() const;
+
+    // axis i may be split while level(i) < CELL_MAX_LEVEL
+    Cell left_half(slong i) const;
+    Cell right_half(slong i) const;
+
+    // the balls, exactly as repeated Box halvings of root would give them
+    Box box(const Box &root) const;
+
+    int operator==(const Cell &c) const;
+    ulong hash() const;
+    // level:index per axis, e.g. "3:5 0:0"
+    std::string str() const;
+
+private:
+    slong d = 0;
+    ulong node[CELL_MAX_DIM] = {};
+};
+
+#endif
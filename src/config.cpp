@@ -5,6 +5,7 @@
 */
 
 #include "config.hpp"
+#include "arb_expr.hpp"
 #include <cassert>
 
 Config::Config(const Arb b1, const Arb b2, const Arb b12) {
@@ -51,8 +52,8 @@ Arb Config::upper_b12() const {
 }
 
 Config Config::from_relative(const Arb& b1, const Arb& b2, const Arb& rel_b12) {
-    Arb b12 = (1 - rel_b12) * lower_b12(b1, b2) +
-                    rel_b12 * upper_b12(b1, b2);
+    Arb b12 = (1 - lazy(rel_b12)) * lower_b12(b1, b2) +
+                    lazy(rel_b12) * upper_b12(b1, b2);
     return Config(b1,b2,b12);
 }
 
@@ -71,7 +72,7 @@ int Config::triangle_check() const {
 }
 
 Arb Config::rho(const Arb& b1, const Arb& b2, const Arb& b12) {
-    Arb num = b12 - b1*b2;
+    Arb num = b12 - lazy(b1)*b2;
     Arb denom = Arb::sqrt((1-b1.sqr())*(1-b2.sqr()));
     return num/denom;
 }
@@ -98,7 +99,7 @@ Arb Config::b12_from_rel_rho(const Arb& b1, const Arb& b2, const Arb& rho) {
     if (z.is_nan()) {
         return Arb(-1, 1);
     }
-    return b1*b2 + rho * z;
+    return lazy(b1)*b2 + lazy(rho) * z;
 }
 
 int Config::tri_check_rel_rho(const Arb& b1, const Arb& b2, const Arb& rho) {
@@ -0,0 +1,37 @@
+/*
+  Copyright (c) 2022-23 Joshua Brakensiek, Neng Huang, Aaron Potechin and Uri Zwick
+
+  This code is licensed under the MIT License.
+*/
+
+#include "escalate.hpp"
+#include <atomic>
+#include <cassert>
+
+// 0 means "the working precision"
+static slong max_prec = 0;
+
+static std::atomic<slong> counts[3];
+
+slong escalate_max_prec() {
+    return max_prec != 0 ? max_prec : Precision::get();
+}
+
+void escalate_set_max_prec(slong prec) {
+    assert(prec == 0 || (MIN_PRECISION <= prec && prec <= MAX_PRECISION));
+    max_prec = prec;
+}
+
+void _escalate_record(EscalateOutcome outcome) {
+    counts[outcome].fetch_add(1, std::memory_order_relaxed);
+}
+
+slong escalate_count(EscalateOutcome outcome) {
+    return counts[outcome].load(std::memory_order_relaxed);
+}
+
+void escalate_print_stats() {
+    flint_printf("ESCALATE: %wd decided, %wd by precision (cap %wd), %wd split\n",
+                 escalate_count(ESCALATE_FIRST), escalate_count(ESCALATE_PREC),
+                 escalate_max_prec(), escalate_count(ESCALATE_SPLIT));
+}
@@ -0,0 +1,67 @@
+/*
+  Copyright (c) 2022-23 Joshua Brakensiek, Neng Huang, Aaron Potechin and Uri Zwick
+
+  This code is licensed under the MIT License.
+*/
+
+#ifndef ESCALATE_HPP
+#define ESCALATE_HPP
+
+#include "precision.hpp"
+
+// Precision escalation for the bisection verifiers.
+//
+// A box can be undecided only because rounding at the working precision
+// inflated the enclosures. Before splitting it, a verifier reruns its
+// tests at twice the precision, then twice that, up to a cap:
+//   if (escalate([&]() { return decide(b1, b2, rho); })) {
+//       return 1;
+//   }
+//   // otherwise we need to split
+// The cap is set with --max-prec=N; by default it equals the working
+// precision, i.e. there is no escalation.
+
+enum EscalateOutcome {
+    ESCALATE_FIRST,   // decided at the working precision
+    ESCALATE_PREC,    // decided after raising the precision
+    ESCALATE_SPLIT    // undecided at every precision up to the cap
+};
+
+slong escalate_max_prec();
+void escalate_set_max_prec(slong prec);
+
+void _escalate_record(EscalateOutcome outcome);
+
+// runs test() until it returns nonzero, raising the precision each time,
+// and returns that value (e.g. a BoxVerdict, see verify.hpp)
+// returns 0 if the box is still undecided (and so must be split)
+template <class F>
+int escalate(F test) {
+    int r = test();
+    if (r) {
+        _escalate_record(ESCALATE_FIRST);
+        return r;
+    }
+
+    slong prec = Precision::get();
+    slong max_prec = escalate_max_prec();
+    while (prec < max_prec) {
+        prec = (2 * prec < max_prec) ? 2 * prec : max_prec;
+        Precision::Scope scope(prec);
+        r = test();
+        if (r) {
+            _escalate_record(ESCALATE_PREC);
+            return r;
+        }
+    }
+
+    _escalate_record(ESCALATE_SPLIT);
+    return 0;
+}
+
+// number of boxes with the given outcome so far
+slong escalate_count(EscalateOutcome outcome);
+
+void escalate_print_stats();
+
+#endif
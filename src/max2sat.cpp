@@ -6,15 +6,16 @@
 
 #include "max2sat.hpp"
 #include "bivariate_normal.hpp"
+#include "arb_expr.hpp"
 #include <cassert>
 
 Arb Max2Sat::value() const {
-    return (3 - (this -> b1) - (this -> b2) - (this -> b12)) / 4;
+    return (3 - lazy(this -> b1) - (this -> b2) - (this -> b12)) / 4;
 }
 
 Arb Max2Sat::prob(const Arb& beta) const {
-    Arb t1 = (1 + beta*(this->b1))/2;
-    Arb t2 = (1 + beta*(this->b2))/2;
+    Arb t1 = (1 + lazy(beta)*(this->b1))/2;
+    Arb t2 = (1 + lazy(beta)*(this->b2))/2;
     return this -> prob(t1, t2);
 }
 
@@ -33,17 +34,17 @@ Arb Max2Sat::obj(const Arb& alpha, const Arb& beta) const {
 
 Arb Max2Sat::value_from_rel(const Arb& b1, const Arb& b2, const Arb& rho) {
     Arb b12 = b12_from_rel_rho(b1, b2, rho);
-    return (3 - b1 - b2 - b12) / 4;
+    return (3 - lazy(b1) - b2 - b12) / 4;
 }
 
 Arb Max2Sat::value_from_rel_d_b1(const Arb& b1, const Arb& b2, const Arb& rho) {
-    Arb x = -(b2+1)/4;
+    Arb x = -(lazy(b2)+1)/4;
     Arb y = rho * b1 * Arb::safe_sqrt(1-b2.sqr()) / (4 * Arb::safe_sqrt(1 - b1.sqr()));
     return x + y;
 }
 
 Arb Max2Sat::value_from_rel_d_b2(const Arb& b1, const Arb& b2, const Arb& rho) {
-    Arb x = -(b1+1)/4;
+    Arb x = -(lazy(b1)+1)/4;
     Arb y = rho * b2 * Arb::safe_sqrt(1-b1.sqr()) / (4 * Arb::safe_sqrt(1 - b2.sqr()));
     return x + y;
 }
@@ -52,58 +53,130 @@ Arb Max2Sat::value_from_rel_d_rho(const Arb& b1, const Arb& b2, const Arb& rho)
     return -Arb::safe_sqrt((1-b1.sqr())*(1-b2.sqr())) / 4;
 }
 
+Gradient3 Max2Sat::value_from_rel_grad(const Arb& b1, const Arb& b2, const Arb& rho) {
+    Arb s1 = Arb::safe_sqrt(1 - b1.sqr());
+    Arb s2 = Arb::safe_sqrt(1 - b2.sqr());
+
+    Gradient3 g;
+    g.value = value_from_rel(b1, b2, rho);
+    g.x = -(lazy(b2)+1)/4 + lazy(rho) * b1 * s2 / (4 * s1);
+    g.y = -(lazy(b1)+1)/4 + lazy(rho) * b2 * s1 / (4 * s2);
+    g.z = -(s1 * s2) / 4;
+    return g;
+}
+
+// partials of 1 - Phi2(t1, t2; rho) when dt_i/db_i = beta/(2 pdf(t_i))
+static Gradient3 _prob_grad(const Arb& t1, const Arb& t2, const Arb& rho, const Arb& beta) {
+    Arb s2 = 1 - lazy(rho)*rho;
+    Arb s = Arb::safe_sqrt(s2);
+    Arb u = (lazy(t2) - lazy(rho) * t1) / s;
+    Arb v = (lazy(t1) - lazy(rho) * t2) / s;
+    Arb c = -lazy(beta) / 2;
+    Arb q = t1.sqr()+t2.sqr() - 2*lazy(rho)*t1*t2;
+
+    Gradient3 g;
+    g.x = c * u.norm_cdf();
+    g.y = c * v.norm_cdf();
+    g.z = Arb::exp(-lazy(q)/(2*s2)) / (-2 * lazy(Arb::pi()) * s);
+    return g;
+}
+
+Gradient3 Max2Sat::prob_from_rel_grad(const Arb& b1, const Arb& b2, const Arb& rho, const Arb& beta) {
+    Arb p1 = (1 + lazy(beta)*b1)/2;
+    Arb p2 = (1 + lazy(beta)*b2)/2;
+    return _prob_grad(p1.norm_cdf_inv(), p2.norm_cdf_inv(), rho, beta);
+}
+
 Arb Max2Sat::prob_from_rel(const Arb& b1, const Arb& b2, const Arb& rho, const Arb& beta) {
-    Arb t1 = (1 + beta*b1)/2;
-    Arb t2 = (1 + beta*b2)/2;
+    Arb t1 = (1 + lazy(beta)*b1)/2;
+    Arb t2 = (1 + lazy(beta)*b2)/2;
     return 1 - biv_norm_cdf_norm_thresh(t1, t2, rho); 
 }
 
 Arb Max2Sat::prob_from_rel_d_b1(const Arb& b1, const Arb& b2, const Arb& rho, const Arb& beta) {
-    Arb t1 = Arb::norm_cdf_inv((1 + beta*b1)/2);
-    Arb t2 = Arb::norm_cdf_inv((1 + beta*b2)/2);
-    Arb c = (t2 - rho * t1) / Arb::safe_sqrt(1 - rho*rho);
-    return (-beta / 2) * c.norm_cdf();
+    Arb t1 = Arb::norm_cdf_inv((1 + lazy(beta)*b1)/2);
+    Arb t2 = Arb::norm_cdf_inv((1 + lazy(beta)*b2)/2);
+    Arb c = (lazy(t2) - lazy(rho) * t1) / Arb::safe_sqrt(1 - lazy(rho)*rho);
+    return (-lazy(beta) / 2) * c.norm_cdf();
 }
 
 Arb Max2Sat::prob_from_rel_d_b2(const Arb& b1, const Arb& b2, const Arb& rho, const Arb& beta) {
-    Arb t1 = Arb::norm_cdf_inv((1 + beta*b1)/2);
-    Arb t2 = Arb::norm_cdf_inv((1 + beta*b2)/2);
-    Arb c = (t1 - rho * t2) / Arb::safe_sqrt(1 - rho*rho);
-    return (-beta / 2) * c.norm_cdf();
+    Arb t1 = Arb::norm_cdf_inv((1 + lazy(beta)*b1)/2);
+    Arb t2 = Arb::norm_cdf_inv((1 + lazy(beta)*b2)/2);
+    Arb c = (lazy(t1) - lazy(rho) * t2) / Arb::safe_sqrt(1 - lazy(rho)*rho);
+    return (-lazy(beta) / 2) * c.norm_cdf();
 }
 
 Arb Max2Sat::prob_from_rel_d_rho(const Arb& b1, const Arb& b2, const Arb& rho, const Arb& beta) {
-    Arb t1 = Arb::norm_cdf_inv((1 + beta*b1)/2);
-    Arb t2 = Arb::norm_cdf_inv((1 + beta*b2)/2);
-    Arb x = -2 * Arb::pi() * Arb::safe_sqrt(1 - rho*rho);
-    Arb y = -(t1.sqr()+t2.sqr() - 2*rho*t1*t2)/(2*(1-rho.sqr()));
+    Arb t1 = Arb::norm_cdf_inv((1 + lazy(beta)*b1)/2);
+    Arb t2 = Arb::norm_cdf_inv((1 + lazy(beta)*b2)/2);
+    Arb x = -2 * lazy(Arb::pi()) * Arb::safe_sqrt(1 - lazy(rho)*rho);
+    Arb q = t1.sqr()+t2.sqr() - 2*lazy(rho)*t1*t2;
+    Arb y = -lazy(q)/(2*(1-rho.sqr()));
     return Arb::exp(y) / x;
 }
 
+Hessian3 Max2Sat::prob_from_rel_hessian(const Arb& b1, const Arb& b2, const Arb& rho, const Arb& beta) {
+    // chain rule through t_i = norm_cdf_inv((1 + beta b_i)/2), whose
+    // derivative is beta/(2 pdf(t_i)); in d2/db1^2 the t1 pdf(t1) cdf(u)
+    // terms of the two halves cancel, leaving
+    //   d2/db1^2   =  beta^2 rho pdf(u) / (4 s pdf(t1))
+    //   d2/db1db2  = -beta^2 pdf(u) / (4 s pdf(t2))
+    //   d2/db1drho =  beta pdf(u) v / (2 s^2)
+    // with s, u, v as in biv_norm_cdf_hessian
+    Arb t1 = Arb::norm_cdf_inv((1 + lazy(beta)*b1)/2);
+    Arb t2 = Arb::norm_cdf_inv((1 + lazy(beta)*b2)/2);
+    Arb s2 = 1 - rho.sqr();
+    Arb s = Arb::safe_sqrt(s2);
+    Arb u = (lazy(t2) - lazy(rho) * t1) / s;
+    Arb v = (lazy(t1) - lazy(rho) * t2) / s;
+    Arb pu = u.norm_pdf();
+    Arb pv = v.norm_pdf();
+    Arb c = beta.sqr() / (4 * s);
+    Arb d = beta / (2 * s2);
+    Arb q = t1.sqr() + t2.sqr() - 2*lazy(rho)*t1*t2;
+
+    Hessian3 h;
+    h.xx = c * rho * pu / t1.norm_pdf();
+    h.yy = c * rho * pv / t2.norm_pdf();
+    h.xy = -c * pu / t2.norm_pdf();
+    h.xz = d * pu * v;
+    h.yz = d * pv * u;
+    h.zz = -(t1.norm_pdf() * pu / s) * (rho + lazy(t1) * t2 - lazy(rho) * q / s2) / s2;
+    return h;
+}
+
 Arb Max2Sat::type3_prob_from_rel(const Arb& b1, const Arb& b2, const Arb& rho, const Arb& beta) {
-    Arb t1 = beta*(1 + b1)/2;
-    Arb t2 = beta*(1 + b2)/2;
+    Arb t1 = lazy(beta)*(1 + b1)/2;
+    Arb t2 = lazy(beta)*(1 + b2)/2;
     return 1 - biv_norm_cdf_norm_thresh(t1, t2, rho); 
 }
 
+Gradient3 Max2Sat::type3_prob_from_rel_grad(const Arb& b1, const Arb& b2, const Arb& rho, const Arb& beta) {
+    Arb p1 = lazy(beta)*(1 + b1)/2;
+    Arb p2 = lazy(beta)*(1 + b2)/2;
+    return _prob_grad(p1.norm_cdf_inv(), p2.norm_cdf_inv(), rho, beta);
+}
+
 Arb Max2Sat::type3_prob_from_rel_d_b1(const Arb& b1, const Arb& b2, const Arb& rho, const Arb& beta) {
-    Arb t1 = Arb::norm_cdf_inv(beta*(1 + b1)/2);
-    Arb t2 = Arb::norm_cdf_inv(beta*(1 + b2)/2);
-    Arb c = (t2 - rho * t1) / Arb::safe_sqrt(1 - rho*rho);
-    return (-beta / 2) * c.norm_cdf();
+    Arb t1 = Arb::norm_cdf_inv(lazy(beta)*(1 + b1)/2);
+    Arb t2 = Arb::norm_cdf_inv(lazy(beta)*(1 + b2)/2);
+    Arb c = (lazy(t2) - lazy(rho) * t1) / Arb::safe_sqrt(1 - lazy(rho)*rho);
+    return (-lazy(beta) / 2) * c.norm_cdf();
 }
 
 Arb Max2Sat::type3_prob_from_rel_d_b2(const Arb& b1, const Arb& b2, const Arb& rho, const Arb& beta) {
-    Arb t1 = Arb::norm_cdf_inv(beta*(1 + b1)/2);
-    Arb t2 = Arb::norm_cdf_inv(beta*(1 + b2)/2);
-    Arb c = (t1 - rho * t2) / Arb::safe_sqrt(1 - rho*rho);
-    return (-beta / 2) * c.norm_cdf();
+    Arb t1 = Arb::norm_cdf_inv(lazy(beta)*(1 + b1)/2);
+    Arb t2 = Arb::norm_cdf_inv(lazy(beta)*(1 + b2)/2);
+    Arb c = (lazy(t1) - lazy(rho) * t2) / Arb::safe_sqrt(1 - lazy(rho)*rho);
+    return (-lazy(beta) / 2) * c.norm_cdf();
 }
 
 Arb Max2Sat::type3_prob_from_rel_d_rho(const Arb& b1, const Arb& b2, const Arb& rho, const Arb& beta) {
-    Arb t1 = Arb::norm_cdf_inv(beta*(1 + b1)/2);
-    Arb t2 = Arb::norm_cdf_inv(beta*(1 + b2)/2);
-    Arb x = -2 * Arb::pi() * Arb::safe_sqrt(1 - rho*rho);
-    Arb y = -(t1.sqr()+t2.sqr() - 2*rho*t1*t2)/(2*(1-rho.sqr()));
+    Arb t1 = Arb::norm_cdf_inv(lazy(beta)*(1 + b1)/2);
+    Arb t2 = Arb::norm_cdf_inv(lazy(beta)*(1 + b2)/2);
+    Arb x = -2 * lazy(Arb::pi()) * Arb::safe_sqrt(1 - lazy(rho)*rho);
+    Arb q = t1.sqr()+t2.sqr() - 2*lazy(rho)*t1*t2;
+    Arb y = -lazy(q)/(2*(1-rho.sqr()));
     return Arb::exp(y) / x;
 }
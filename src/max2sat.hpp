@@ -9,6 +9,7 @@
 
 #include "arb_wrapper.hpp"
 #include "config.hpp"
+#include "bivariate_normal.hpp"
 
 class Max2Sat : public Config {
 public:
@@ -31,18 +32,28 @@ public:
     static Arb value_from_rel_d_b1(const Arb& b1, const Arb& b2, const Arb& rho);
     static Arb value_from_rel_d_b2(const Arb& b1, const Arb& b2, const Arb& rho);
     static Arb value_from_rel_d_rho(const Arb& b1, const Arb& b2, const Arb& rho);
+    // value_from_rel and its partials in (b1, b2, rho)
+    static Gradient3 value_from_rel_grad(const Arb& b1, const Arb& b2, const Arb& rho);
 
     // for type 4/5
     static Arb prob_from_rel(const Arb& b1, const Arb& b2, const Arb& rho, const Arb& beta);
     static Arb prob_from_rel_d_b1(const Arb& b1, const Arb& b2, const Arb& rho, const Arb& beta);
     static Arb prob_from_rel_d_b2(const Arb& b1, const Arb& b2, const Arb& rho, const Arb& beta);
     static Arb prob_from_rel_d_rho(const Arb& b1, const Arb& b2, const Arb& rho, const Arb& beta);  
+    // the partials of prob_from_rel in (b1, b2, rho), inverting each
+    // threshold once instead of once per partial; value is left 0, as it
+    // costs the rho integrals the caller usually has from prob_from_rel
+    static Gradient3 prob_from_rel_grad(const Arb& b1, const Arb& b2, const Arb& rho, const Arb& beta);
+    // second partials in (b1, b2, rho)
+    static Hessian3 prob_from_rel_hessian(const Arb& b1, const Arb& b2, const Arb& rho, const Arb& beta);
 
     // for type 3
     static Arb type3_prob_from_rel(const Arb& b1, const Arb& b2, const Arb& rho, const Arb& beta);
     static Arb type3_prob_from_rel_d_b1(const Arb& b1, const Arb& b2, const Arb& rho, const Arb& beta);
     static Arb type3_prob_from_rel_d_b2(const Arb& b1, const Arb& b2, const Arb& rho, const Arb& beta);
     static Arb type3_prob_from_rel_d_rho(const Arb& b1, const Arb& b2, const Arb& rho, const Arb& beta);  
+    // as prob_from_rel_grad, value is left 0
+    static Gradient3 type3_prob_from_rel_grad(const Arb& b1, const Arb& b2, const Arb& rho, const Arb& beta);
 
 };
 
@@ -0,0 +1,34 @@
+/*
+  Copyright (c) 2022-23 Joshua Brakensiek, Neng Huang, Aaron Potechin and Uri Zwick
+
+  This code is licensed under the MIT License.
+*/
+
+#include "precision.hpp"
+#include <cassert>
+
+thread_local slong Precision::current = 0;
+slong Precision::default_prec = DEFAULT_PRECISION;
+
+void Precision::set(slong prec) {
+    assert(MIN_PRECISION <= prec && prec <= MAX_PRECISION);
+    current = prec;
+}
+
+slong Precision::get_default() {
+    return default_prec;
+}
+
+void Precision::set_default(slong prec) {
+    assert(MIN_PRECISION <= prec && prec <= MAX_PRECISION);
+    default_prec = prec;
+}
+
+Precision::Scope::Scope(slong prec) {
+    saved = current;
+    set(prec);
+}
+
+Precision::Scope::~Scope() {
+    current = saved;
+}
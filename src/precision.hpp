@@ -0,0 +1,58 @@
+/*
+  Copyright (c) 2022-23 Joshua Brakensiek, Neng Huang, Aaron Potechin and Uri Zwick
+
+  This code is licensed under the MIT License.
+*/
+
+#ifndef PRECISION_HPP
+#define PRECISION_HPP
+
+#include "flint.h"
+
+#define DEFAULT_PRECISION 64
+#define MIN_PRECISION 16
+#define MAX_PRECISION 4096
+
+// Working precision (in bits) of every Arb/Acb operation.
+//
+// Each thread has its own value, which starts out as the process-wide
+// default (settable with --prec=N, see args.hpp). Code that wants a
+// different precision for a while should use a Precision::Scope:
+//   {
+//       Precision::Scope s(2 * Precision::get());
+//       ... // evaluated at double the precision
+//   } // previous precision restored
+class Precision {
+public:
+    // inline since it is called by every arithmetic operation
+    static slong get() {
+        return current != 0 ? current : default_prec;
+    }
+
+    // precision of the calling thread
+    static void set(slong prec);
+
+    // default for threads which have not called set()
+    static slong get_default();
+    static void set_default(slong prec);
+
+    class Scope {
+    public:
+        explicit Scope(slong prec);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        slong saved;
+    };
+
+private:
+    // 0 means "not set, use the default"
+    static thread_local slong current;
+    // only written before worker threads are started
+    static slong default_prec;
+};
+
+#endif
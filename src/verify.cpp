@@ -0,0 +1,260 @@
+/*
+  Copyright (c) 2022-23 Joshua Brakensiek, Neng Huang, Aaron Potechin and Uri Zwick
+
+  This code is licensed under the MIT License.
+*/
+
+#include "verify.hpp"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+static std::atomic<slong> splits(0), max_depth(0), max_live(0);
+
+// only written before a search starts
+static slong threads = 1;
+static slong spawn_depth = VERIFY_DEFAULT_SPAWN_DEPTH;
+static slong max_depth_cap = 0;
+static slong max_boxes_cap = 0;
+static std::string report_path;
+
+slong split_widest(const Box &box) {
+    return box.widest();
+}
+
+void describe_nothing(FILE* out, const Box &box) {
+}
+
+void verify_fprint(FILE* out, const char* name, const Arb &x) {
+    char* s = arb_get_str(x.t, 20, 0);
+    fprintf(out, "%s: %s\n", name, s);
+    flint_free(s);
+}
+
+slong verify_threads() {
+    return threads;
+}
+
+void verify_set_threads(slong n) {
+    assert(n >= 1);
+    threads = n;
+}
+
+slong verify_spawn_depth() {
+    return spawn_depth;
+}
+
+void verify_set_spawn_depth(slong depth) {
+    assert(depth >= 0);
+    spawn_depth = depth;
+}
+
+slong verify_max_depth_cap() {
+    return max_depth_cap;
+}
+
+void verify_set_max_depth_cap(slong depth) {
+    assert(depth >= 0);
+    max_depth_cap = depth;
+}
+
+slong verify_max_boxes_cap() {
+    return max_boxes_cap;
+}
+
+void verify_set_max_boxes_cap(slong n) {
+    assert(n >= 0);
+    max_boxes_cap = n;
+}
+
+void verify_set_report(const char* path) {
+    report_path = (path != NULL) ? path : "";
+}
+
+void _verify_record_split(slong depth) {
+    splits.fetch_add(1, std::memory_order_relaxed);
+    slong d = max_depth.load(std::memory_order_relaxed);
+    while (depth + 1 > d && !max_depth.compare_exchange_weak(d, depth + 1)) {
+    }
+}
+
+void _verify_record_live(slong live) {
+    slong m = max_live.load(std::memory_order_relaxed);
+    while (live > m && !max_live.compare_exchange_weak(m, live)) {
+    }
+}
+
+// failures
+
+int VerifyToken::cancel(BoxVerdict v) {
+    int expected = 0;
+    if (!flag.compare_exchange_strong(expected, 1)) {
+        return 0;
+    }
+    // read by run() after the search, i.e. after the workers are joined
+    failure = v;
+    return 1;
+}
+
+BoxVerdict VerifyToken::verdict() const {
+    return cancelled() ? failure : BOX_PROVEN;
+}
+
+FILE* _verify_report_begin(const char* why, const Cell &cell, const Box &box) {
+    FILE* out = stdout;
+    if (!report_path.empty()) {
+        out = fopen(report_path.c_str(), "w");
+        if (out == NULL) {
+            // the report still goes somewhere
+            flint_printf("cannot write %s\n", report_path.c_str());
+            out = stdout;
+        }
+    }
+    fflush(stdout);
+
+    fprintf(out, "VERIFY FAILED: %s, depth %ld\n", why, (long) cell.depth());
+    fprintf(out, "cell: %s\n", cell.str().c_str());
+    for (slong i = 0; i < box.dim(); i++) {
+        std::string name = "x" + std::to_string(i);
+        verify_fprint(out, name.c_str(), box[i]);
+    }
+    return out;
+}
+
+void _verify_report_end(FILE* out) {
+    if (out == stdout) {
+        fflush(out);
+    }
+    else {
+        fclose(out);
+    }
+}
+
+// work stealing
+
+class _VerifyDeque {
+public:
+    std::mutex mutex;
+    std::deque<Cell> tasks;
+};
+
+class _VerifyPool {
+public:
+    _VerifyPool(slong n, const _VerifySearch &search) : deques(n), search(search) {}
+
+    // one per thread: the owner works at the back, thieves take the front
+    std::vector<_VerifyDeque> deques;
+    const _VerifySearch &search;
+    // queued or running tasks; the search is over when it reaches 0
+    std::atomic<slong> pending{0};
+    // idle threads wait here for new tasks
+    std::mutex idle_mutex;
+    std::condition_variable idle;
+};
+
+static thread_local _VerifyPool* pool = NULL;
+static thread_local slong pool_index = 0;
+
+int _verify_spawn(const Cell &cell) {
+    if (pool == NULL) {
+        return 0;
+    }
+    pool->pending.fetch_add(1);
+    _VerifyDeque& d = pool->deques[pool_index];
+    {
+        std::lock_guard<std::mutex> lock(d.mutex);
+        d.tasks.push_back(cell);
+    }
+    pool->idle.notify_one();
+    return 1;
+}
+
+// newest task of our own deque, or else the oldest of someone else's
+static int _verify_take(_VerifyPool &p, slong me, Cell &task) {
+    slong n = p.deques.size();
+    for (slong k = 0; k < n; k++) {
+        _VerifyDeque& d = p.deques[(me + k) % n];
+        std::lock_guard<std::mutex> lock(d.mutex);
+        if (d.tasks.empty()) {
+            continue;
+        }
+        if (k == 0) {
+            task = d.tasks.back();
+            d.tasks.pop_back();
+        }
+        else {
+            task = d.tasks.front();
+            d.tasks.pop_front();
+        }
+        return 1;
+    }
+    return 0;
+}
+
+static void _verify_work(_VerifyPool &p, slong me) {
+    pool = &p;
+    pool_index = me;
+
+    Cell task;
+    while (p.pending.load() > 0) {
+        if (!_verify_take(p, me, task)) {
+            // the timeout covers a spawn between the take and the wait
+            std::unique_lock<std::mutex> lock(p.idle_mutex);
+            p.idle.wait_for(lock, std::chrono::milliseconds(1));
+            continue;
+        }
+        // once the search is cancelled this returns at once, so the
+        // remaining tasks are only drained
+        p.search(task);
+        if (p.pending.fetch_sub(1) == 1) {
+            p.idle.notify_all();
+        }
+    }
+
+    pool = NULL;
+}
+
+void _verify_parallel(const Cell &cell, const _VerifySearch &search) {
+    _VerifyPool p(verify_threads(), search);
+    p.pending = 1;
+    p.deques[0].tasks.push_back(cell);
+
+    // workers inherit the caller's precision, not the default one
+    slong prec = Precision::get();
+    std::vector<std::thread> workers;
+    for (slong i = 1; i < verify_threads(); i++) {
+        workers.emplace_back([&p, i, prec]() {
+            Precision::set(prec);
+            _verify_work(p, i);
+            flint_cleanup();
+        });
+    }
+    _verify_work(p, 0);
+    for (std::thread& w : workers) {
+        w.join();
+    }
+}
+
+slong verify_splits() {
+    return splits.load(std::memory_order_relaxed);
+}
+
+slong verify_max_depth() {
+    return max_depth.load(std::memory_order_relaxed);
+}
+
+slong verify_max_live() {
+    return max_live.load(std::memory_order_relaxed);
+}
+
+void verify_print_stats() {
+    flint_printf("VERIFY: %wd splits, depth %wd, %wd boxes waiting, %wd threads\n",
+                 verify_splits(), verify_max_depth(), verify_max_live(),
+                 verify_threads());
+}
@@ -0,0 +1,226 @@
+/*
+  Copyright (c) 2022-23 Joshua Brakensiek, Neng Huang, Aaron Potechin and Uri Zwick
+
+  This code is licensed under the MIT License.
+*/
+
+#ifndef VERIFY_HPP
+#define VERIFY_HPP
+
+#include "box.hpp"
+#include "escalate.hpp"
+#include <atomic>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+// Branch and bound over boxes.
+//
+// A verifier proves a claim on a whole box by bisection: decide(box)
+// returns BOX_PROVEN if the claim holds on all of the box, BOX_REFUTED if
+// it certainly fails somewhere in it, and BOX_UNDECIDED otherwise. An
+// undecided box is retried at higher precision (see escalate.hpp), then
+// split along the axis chosen by split(box), by default the widest one:
+//   auto decide = [](const Box &x) { ... };
+//   BoxVerdict v = verify_box(Box{b1_range, b2_range, rho_range}, decide);
+// The search stops at the first box that fails: one that is refuted, or
+// still undecided after --max-depth=N splits, or whose split would leave
+// more than --max-boxes=N boxes waiting (by default neither is capped).
+// It is written, with its depth and whatever describe(out, box) prints
+// about it, to the file given by --report=PATH, or else to stdout.
+//
+// The search does not recurse: each thread keeps the boxes it still has
+// to look at on its own frontier, a stack with the left half of the last
+// split on top, so a deep search costs heap memory, not stack frames.
+// Boxes are kept as cells of the root (see box.hpp), a word per axis, and
+// only turned into balls for decide. A box may be split at most
+// CELL_MAX_LEVEL times along each axis; past that it fails like one at
+// --max-depth.
+//
+// With --threads=N the search runs on N threads (the caller and N-1
+// workers), so decide and split must then be safe to call concurrently.
+// A split at most --spawn-depth=D levels deep queues its right half on
+// the splitting thread's deque and goes on with the left half; idle
+// threads steal the oldest (largest) queued boxes from the others.
+// Deeper subtrees are searched by the thread that reached them.
+
+enum BoxVerdict {
+    BOX_UNDECIDED = 0,
+    BOX_PROVEN,
+    BOX_REFUTED
+};
+
+// split policy: the widest axis
+slong split_widest(const Box &box);
+// describe policy: nothing beyond the box itself
+void describe_nothing(FILE* out, const Box &box);
+
+// name: x, one line, for describe()
+void verify_fprint(FILE* out, const char* name, const Arb &x);
+
+#define VERIFY_DEFAULT_SPAWN_DEPTH 24
+
+slong verify_threads();
+void verify_set_threads(slong n);
+slong verify_spawn_depth();
+void verify_set_spawn_depth(slong depth);
+// 0 means no cap
+slong verify_max_depth_cap();
+void verify_set_max_depth_cap(slong depth);
+// boxes waiting on all frontiers and deques; 0 means no cap
+slong verify_max_boxes_cap();
+void verify_set_max_boxes_cap(slong n);
+// NULL for stdout
+void verify_set_report(const char* path);
+
+void _verify_record_split(slong depth);
+void _verify_record_live(slong live);
+
+// shared by all threads of one search: the first failure cancels the rest
+class VerifyToken {
+public:
+    int cancelled() const {
+        return flag.load(std::memory_order_relaxed);
+    }
+
+    // 1 for the first caller only, which then owns the report
+    int cancel(BoxVerdict v);
+
+    // BOX_PROVEN unless cancelled
+    BoxVerdict verdict() const;
+
+private:
+    std::atomic<int> flag{0};
+    BoxVerdict failure = BOX_PROVEN;
+};
+
+// the report of a failed box, before and after describe() adds to it
+FILE* _verify_report_begin(const char* why, const Cell &cell, const Box &box);
+void _verify_report_end(FILE* out);
+
+typedef std::function<void(const Cell&)> _VerifySearch;
+// search(cell) on verify_threads() threads
+void _verify_parallel(const Cell &cell, const _VerifySearch &search);
+// inside _verify_parallel, queues search(cell) and returns 1; returns 0
+// (and the caller must search the cell itself) outside of it
+int _verify_spawn(const Cell &cell);
+
+template <class D, class S, class R>
+class BoxVerifier {
+public:
+    BoxVerifier(D &decide, S &split, R &describe)
+        : decide(decide), split(split), describe(describe) {}
+
+    BoxVerdict run(const Box &box) {
+        root = box;
+        live = 1;
+        if (verify_threads() <= 1) {
+            search(Cell(box.dim()));
+        }
+        else {
+            _verify_parallel(Cell(box.dim()), [this](const Cell &c) {
+                search(c);
+            });
+        }
+        return token.verdict();
+    }
+
+private:
+    // depth first from cell, handing right halves to other threads while
+    // they are shallow enough
+    void search(const Cell &cell) {
+        std::vector<Cell> frontier;
+        frontier.push_back(cell);
+
+        while (!frontier.empty()) {
+            // another thread failed: the answer is known already
+            if (token.cancelled()) {
+                return;
+            }
+            Cell c = frontier.back();
+            frontier.pop_back();
+            Box b = c.box(root);
+            slong depth = c.depth();
+
+            BoxVerdict v = (BoxVerdict) escalate([&]() { return decide(b); });
+            if (v == BOX_PROVEN) {
+                live.fetch_sub(1, std::memory_order_relaxed);
+                continue;
+            }
+            if (v == BOX_REFUTED) {
+                fail(v, "refuted", c, b);
+                return;
+            }
+            slong cap = verify_max_depth_cap();
+            if (cap != 0 && depth >= cap) {
+                fail(v, "undecided at depth limit", c, b);
+                return;
+            }
+            slong i = split(b);
+            if (c.level(i) >= CELL_MAX_LEVEL) {
+                fail(v, "undecided at cell limit", c, b);
+                return;
+            }
+
+            // one box becomes two
+            slong n = live.fetch_add(1, std::memory_order_relaxed) + 1;
+            _verify_record_live(n);
+            slong boxes_cap = verify_max_boxes_cap();
+            if (boxes_cap != 0 && n > boxes_cap) {
+                fail(v, "undecided at box limit", c, b);
+                return;
+            }
+
+            _verify_record_split(depth);
+#ifdef DEBUG
+            flint_printf("SPLIT: %wd\n", i);
+            b.println();
+#endif
+            Cell right = c.right_half(i);
+            if (!(depth < verify_spawn_depth() && _verify_spawn(right))) {
+                frontier.push_back(right);
+            }
+            frontier.push_back(c.left_half(i));
+        }
+    }
+
+    void fail(BoxVerdict v, const char* why, const Cell &cell, const Box &box) {
+        if (token.cancel(v)) {
+            FILE* out = _verify_report_begin(why, cell, box);
+            describe(out, box);
+            _verify_report_end(out);
+        }
+    }
+
+    D &decide;
+    S &split;
+    R &describe;
+    Box root;
+    VerifyToken token;
+    // boxes waiting or being decided, on all threads
+    std::atomic<slong> live{0};
+};
+
+// BOX_PROVEN if decide proves every leaf; otherwise the verdict of the
+// reported box: BOX_REFUTED, or BOX_UNDECIDED at the depth or box cap
+template <class D, class S, class R>
+BoxVerdict verify_box(const Box &box, D decide, S split, R describe) {
+    return BoxVerifier<D, S, R>(decide, split, describe).run(box);
+}
+
+template <class D, class S>
+BoxVerdict verify_box(const Box &box, D decide, S split) {
+    return verify_box(box, decide, split, describe_nothing);
+}
+
+template <class D>
+BoxVerdict verify_box(const Box &box, D decide) {
+    return verify_box(box, decide, split_widest, describe_nothing);
+}
+
+slong verify_splits();
+slong verify_max_depth();
+slong verify_max_live();
+void verify_print_stats();
+
+#endif
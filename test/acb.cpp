@@ -54,6 +54,12 @@ int main(int argc, char* argv[]) {
     Acb(0.0).norm_pdf().println();
     Acb(1.96).norm_cdf().println();
 
+    (v * 0.5).println();
+    (v - 3).println();
+    (1 - v).println();
+    (2 / v).println();
+    (Arb(2.0) * v).println();
+
     flint_printf("%d\n", v.is_nan());
     flint_printf("%d\n", Acb::nan().is_nan());
     flint_printf("%d\n", sizeof(Acb));
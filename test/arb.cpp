@@ -4,8 +4,11 @@
   This code is licensed under the MIT License.
 */
 
+#include <cassert>
+#include <chrono>
 #include <cstdio>
 #include "arb_wrapper.hpp"
+#include "arb_expr.hpp"
 #define NUM_THREADS 1
 
 
@@ -52,6 +55,14 @@ int main(int argc, char* argv[]) {
     (Arb::pow(w,2)).println();
 
     (Arb::pi()).println();
+    Arb::sqrt2().println();
+    Arb::inv_sqrt2().println();
+    Arb::inv_sqrt_2pi().println();
+    Arb::log_2pi().println();
+    {
+        Precision::Scope s(128);
+        Arb::pi().println();
+    }
 
     (Arb::norm_pdf(0)).println();
     (Arb::norm_pdf(1)).println();
@@ -103,6 +114,14 @@ int main(int argc, char* argv[]) {
 
     w.left_half().println();
     w.right_half().println();
+
+    // the halves meet exactly at the midpoint
+    std::pair<Arb, Arb> h = Arb(0.1, 0.7).split();
+    h.first.println();
+    h.second.println();
+    flint_printf("%d\n", h.first.right_edge() == h.second.left_edge());
+    flint_printf("%d\n", h.first.left_edge() == Arb(0.1, 0.7).left_edge());
+    Arb::nan().left_half().println();
     (2*w-2.5).println();
     w.min(2*w-2.5).println();
     w.max(2*w-2.5).println();
@@ -110,6 +129,74 @@ int main(int argc, char* argv[]) {
     Arb::abs(w-2.5).println();
     Arb::abs(w-3.5).println();
 
+    // fused expressions
+    Arb u(0.1, 0.3);
+    Arb f1 = (1 + lazy(u)*w)/2;
+    f1.println();
+    ((1 + u*w)/2).println();
+    Arb f2 = w.sqr() + u.sqr() - 2*lazy(u)*w*u;
+    f2.println();
+    (w.sqr() + u.sqr() - 2*u*w*u).println();
+    Arb f3 = 1 - lazy(u)*u;
+    f3.println();
+    (1 - u*u).println();
+    Arb f4 = -lazy(w)/3 + 0.5*lazy(u);
+    f4.println();
+
+    // operations with a double: integer, power of two and general
+    (u + 3).println();
+    (u * 0.25).println();
+    (u / -4).println();
+    (u * 0.1).println();
+    (1.5 - u).println();
+    (2 / u).println();
+    (0.3 / u).println();
+
+    // monotone functions on wide balls: endpoints vs whole ball
+    Arb wide(-0.5, 1.5);
+    wide.norm_cdf().println();
+    Arb::erf(wide).println();
+    Arb(0.2, 0.9).norm_cdf_inv().println();
+    Arb(-0.7, 0.1).erf_inv().println();
+    slong e = Arb::monotone_threshold();
+    Arb::set_monotone_threshold(10);
+    wide.norm_cdf().println();
+    Arb(0.2, 0.9).norm_cdf_inv().println();
+    Arb::set_monotone_threshold(e);
+
+    // tails
+    Arb(-30.0).norm_cdf().println();
+    Arb(30.0).norm_sf().println();
+    Arb(8.0).norm_cdf().println();
+    Arb(-30.0).log_norm_cdf().println();
+    Arb(5.0).log_norm_cdf().println();
+    Arb(10.0).mills_ratio().println();
+    Arb(0.0).mills_ratio().println();
+
+    // inverse normal: Newton from a double seed vs erf_inv
+    Arb(0.975).norm_cdf_inv().println();
+    Arb(0.975).norm_cdf_inv_erf().println();
+    Arb(1e-300).norm_cdf_inv().println();
+    Arb(0.3, 0.300001).norm_cdf_inv().println();
+    Arb(1.5).norm_cdf_inv().println();
+
+    double newton_time = 0, erf_time = 0, width_ratio = 0;
+    int count = 999;
+    for (int i = 1; i <= count; i++) {
+        Arb p = Arb(i) / 1000;
+        auto t0 = std::chrono::steady_clock::now();
+        Arb x = p.norm_cdf_inv();
+        auto t1 = std::chrono::steady_clock::now();
+        Arb y = p.norm_cdf_inv_erf();
+        auto t2 = std::chrono::steady_clock::now();
+        newton_time += std::chrono::duration<double>(t1 - t0).count();
+        erf_time += std::chrono::duration<double>(t2 - t1).count();
+        width_ratio += mag_get_d(arb_radref(x.t)) / mag_get_d(arb_radref(y.t)) / count;
+        assert(arb_overlaps(x.t, y.t));
+    }
+    flint_printf("norm_cdf_inv speedup: %.2f, mean width ratio: %.3f\n",
+                 erf_time / newton_time, width_ratio);
+
     flint_cleanup_master();
 
     return 0;
@@ -6,6 +6,9 @@
 
 #include <cstdio>
 #include "bivariate_normal.hpp"
+#include "biv_cache.hpp"
+#include "biv_store.hpp"
+#include "biv_model.hpp"
 #define NUM_THREADS 1
 
 int main(int argc, char* argv[]) {
@@ -76,6 +79,199 @@ int main(int argc, char* argv[]) {
     biv_norm_cdf(0,10,0.1).println();
     biv_norm_cdf(10,10,0.1).println();
 
+    // Owen's T function and engine
+    owens_t(0.5, 0.3).println();
+    owens_t(2.0, 1.4).println();
+    owens_t(-1.0, -2.0).println();
+    owens_t(0.0, 1.0).println();
+    owens_t(40.0, 0.5).println();
+
+    flint_printf("\n");
+
+    biv_norm_cdf_owen_t(0.3, -0.4, 0.5).println();
+    biv_norm_cdf_quadrature(0.3, -0.4, 0.5).println();
+    biv_norm_cdf_owen_t(0, 1.3, 0.4).println();
+    biv_norm_cdf_quadrature(0, 1.3, 0.4).println();
+    biv_norm_cdf_owen_t(-2, -1, 0.99).println();
+    biv_norm_cdf_quadrature(-2, -1, 0.99).println();
+    biv_norm_cdf_owen_t(0, 0, 0.3).println();
+    // a large h with a small a needs many terms after q a^2 is passed:
+    // here a = sqrt((1 - rho)/(1 + rho)) is about 0.1, then 0.05
+    Arb owen_far = biv_norm_cdf_owen_t(-7.7, -7.7, 0.98);
+    Arb quad_far = biv_norm_cdf_quadrature(-7.7, -7.7, 0.98);
+    flint_printf("%d\n", arb_overlaps(owen_far.t, quad_far.t));
+    owen_far = biv_norm_cdf_owen_t(-6, -6, 0.995);
+    quad_far = biv_norm_cdf_quadrature(-6, -6, 0.995);
+    flint_printf("%d\n", arb_overlaps(owen_far.t, quad_far.t));
+    biv_norm_cdf_owen_t(r, 0.5, 0.3).println();
+
+    biv_norm_set_engine(BIV_NORM_CROSS_CHECK);
+    biv_norm_cdf(0.1, 0.1, 0.1).println();
+    biv_norm_cdf(0.5, -1.5, Arb(-0.5, 0.9)).println();
+    biv_norm_set_engine(BIV_NORM_QUADRATURE);
+
+    // Gauss-Legendre integral of d/drho
+    biv_norm_cdf_d_rho_integral(0.3, -0.4, 0, 0.5).println();
+    biv_norm_cdf_d_rho_integral(0.3, -0.4, 0.5, 0).println();
+    biv_norm_cdf_d_rho_integral(1, 1, -0.9, 0.9).println();
+    biv_norm_cdf_d_rho_integral(0, 0, 0, 0.99999).println();
+    biv_norm_cdf_d_rho_integral(-2, 3, 0.2, 0.2).println();
+
+    // paired endpoints share the [0, lo] integral
+    std::pair<Arb, Arb> ends = biv_norm_cdf_unsafe_pair(0.3, -0.4, 0.2, 0.6);
+    ends.first.println();
+    biv_norm_cdf_unsafe(0.3, -0.4, 0.2).println();
+    ends.second.println();
+    biv_norm_cdf_unsafe(0.3, -0.4, 0.6).println();
+    biv_norm_cdf(0.3, -0.4, Arb(0.2, 0.6)).println();
+    // as the drivers call it: the thresholds become norm_cdf_inv balls,
+    // which are narrow but not exact, and are still paired
+    slong paired = biv_norm_integ_count(BIV_INTEG_PAIRED);
+    biv_norm_cdf_norm_thresh(Arb(0.55, 0.6), Arb(0.3, 0.35), Arb(0.2, 0.3)).println();
+    flint_printf("%wd\n", biv_norm_integ_count(BIV_INTEG_PAIRED) - paired);
+
+    // memoized point evaluations
+    biv_cache_clear();
+    slong hits = biv_cache_hits();
+    biv_norm_cdf_unsafe(0.7, 0.2, 0.3).println();
+    biv_norm_cdf_unsafe(0.7, 0.2, 0.3).println();
+    slong new_hits = biv_cache_hits();
+    flint_printf("%wd\n", new_hits - hits);
+    // keys are exact: the same balls give the same key, a different one not
+    BivCacheKey k1, k2, k3;
+    flint_printf("%d", biv_cache_key(k1, 0.7, Arb(0.2).norm_cdf_inv(), 0.3));
+    flint_printf("%d", biv_cache_key(k2, 0.7, Arb(0.2).norm_cdf_inv(), 0.3));
+    flint_printf("%d", biv_cache_key(k3, 0.7, Arb(0.2).norm_cdf_inv(), 0.4));
+    flint_printf(" %d %d %d\n", k1 == k2, k1.hash == k2.hash, k1 == k3);
+    biv_cache_set_capacity(1);
+    biv_norm_cdf_unsafe(0.7, 0.2, 0.4).println();
+    flint_printf("%wd\n", biv_cache_size());
+    biv_cache_set_capacity(BIV_CACHE_DEFAULT_CAPACITY);
+
+    // on-disk memo: a second open sees the first one's values
+    const char* path = "biv_store_test.bin";
+    remove(path);
+    flint_printf("%d\n", biv_store_open(path));
+    biv_cache_set_capacity(0);
+    biv_norm_cdf_unsafe(-0.3, 0.8, 0.25).println();
+    biv_store_close();
+    flint_printf("%d\n", biv_store_open(path));
+    slong store_hits = biv_store_hits();
+    biv_norm_cdf_unsafe(-0.3, 0.8, 0.25).println();
+    slong new_store_hits = biv_store_hits();
+    flint_printf("%wd %wd\n", new_store_hits - store_hits, biv_store_size());
+    biv_store_close();
+    // a full index neither takes nor appends more: one value stays one
+    biv_store_set_capacity(1);
+    flint_printf("%d\n", biv_store_open(path));
+    biv_norm_cdf_unsafe(-0.2, 0.5, 0.1).println();
+    flint_printf("%wd\n", biv_store_size());
+    biv_store_close();
+    biv_store_set_capacity(BIV_STORE_DEFAULT_CAPACITY);
+    biv_cache_set_capacity(BIV_CACHE_DEFAULT_CAPACITY);
+    // values of another engine are refused
+    biv_norm_set_engine(BIV_NORM_OWEN_T);
+    flint_printf("%d\n", biv_store_open(path));
+    biv_norm_set_engine(BIV_NORM_QUADRATURE);
+    remove(path);
+
+    // certified model over a small box
+    Arb mlo[3] = {0.2, -0.5, 0.3};
+    Arb mhi[3] = {0.25, -0.45, 0.35};
+    BivNormModel model = BivNormModel::fit(mlo, mhi, 4, 4);
+    model.rem.println();
+    flint_printf("%d %d\n", model.contains(0.22, -0.47, 0.31), model.contains(0.3, -0.47, 0.31));
+    model.eval(0.22, -0.47, 0.31).println();
+    biv_norm_cdf_unsafe(0.22, -0.47, 0.31).println();
+    const char* mpath = "biv_model_test.txt";
+    flint_printf("%d\n", model.save(mpath));
+    flint_printf("%d\n", biv_model_load(mpath));
+    Arb from_model;
+    // the remainder is too wide for the default 64 bits, and above them
+    // a refit would be needed; at the bits the remainder allows it is used
+    slong model_prec = -arf_abs_bound_lt_2exp_si(arb_midref(model.rem.t));
+    model_prec = FLINT_MAX(FLINT_MIN(model_prec, model.prec), MIN_PRECISION);
+    flint_printf("%d", biv_model_lookup(from_model, 0.22, -0.47, 0.31));
+    {
+        Precision::Scope s(128);
+        flint_printf(" %d", biv_model_lookup(from_model, 0.22, -0.47, 0.31));
+    }
+    {
+        Precision::Scope s(model_prec);
+        flint_printf(" %d\n", biv_model_lookup(from_model, 0.22, -0.47, 0.31));
+        from_model.println();
+        biv_model_set_enabled(0);
+        flint_printf("%d\n", biv_model_lookup(from_model, 0.22, -0.47, 0.31));
+        biv_model_set_enabled(1);
+    }
+    remove(mpath);
+
+    // closed forms agree with quadrature; t1 = t2 uses Owen's T, so
+    // only with that engine
+    biv_norm_set_engine(BIV_NORM_OWEN_T);
+    slong sym = biv_norm_fast_count(BIV_FAST_SYMMETRIC);
+    biv_norm_cdf_unsafe(0.6, 0.6, -0.3).println();
+    biv_norm_cdf_quadrature(0.6, 0.6, -0.3).println();
+    biv_norm_cdf_unsafe(-1.2, -1.2, 0.8).println();
+    biv_norm_cdf_quadrature(-1.2, -1.2, 0.8).println();
+    biv_norm_cdf_unsafe(Arb(-0.1, 0.1), Arb(-0.1, 0.1), 0.5).println();
+    // far out with rho in (0, 1), where a = sqrt((1 - rho)/(1 + rho))
+    // is small and the series is long
+    Arb sym_fast, sym_quad;
+    for (double t : {-5.0, -7.7, 6.0}) {
+        for (double rh : {0.3, 0.9, 0.98, 0.995}) {
+            sym_fast = biv_norm_cdf_unsafe(t, t, rh);
+            sym_quad = biv_norm_cdf_quadrature(t, t, rh);
+            flint_printf("%d", arb_overlaps(sym_fast.t, sym_quad.t));
+        }
+    }
+    flint_printf("\n");
+    slong new_sym = biv_norm_fast_count(BIV_FAST_SYMMETRIC);
+    flint_printf("%wd\n", new_sym - sym);
+    biv_norm_set_engine(BIV_NORM_QUADRATURE);
+    // the default engine leaves t1 = t2 to quadrature
+    biv_norm_cdf_unsafe(0.6, 0.6, -0.2).println();
+    flint_printf("%wd\n", biv_norm_fast_count(BIV_FAST_SYMMETRIC) - new_sym);
+    slong zero = biv_norm_fast_count(BIV_FAST_RHO_ZERO);
+    biv_norm_cdf_unsafe(0.4, -1.1, 0).println();
+    biv_norm_cdf_quadrature(0.4, -1.1, 0).println();
+    slong new_zero = biv_norm_fast_count(BIV_FAST_RHO_ZERO);
+    flint_printf("%wd\n", new_zero - zero);
+
+    // integrator statistics
+    slong calls = biv_norm_integ_count(BIV_INTEG_CALLS);
+    slong pieces = biv_norm_integ_count(BIV_INTEG_GL_PIECES);
+    biv_norm_cdf_d_rho_integral(0.3, -0.7, 0, 0.9).println();
+    flint_printf("%wd\n", biv_norm_integ_count(BIV_INTEG_CALLS) - calls);
+    flint_printf("%d\n", biv_norm_integ_count(BIV_INTEG_GL_PIECES) - pieces > 0);
+    // a rejected piece is either halved or left to acb_calc_integrate
+    flint_printf("%d %d\n",
+                 biv_norm_integ_count(BIV_INTEG_GL_PIECES) ==
+                 biv_norm_integ_count(BIV_INTEG_CALLS) +
+                 2 * biv_norm_integ_count(BIV_INTEG_GL_SPLITS),
+                 biv_norm_integ_count(BIV_INTEG_GL_REJECTS) ==
+                 biv_norm_integ_count(BIV_INTEG_GL_SPLITS) +
+                 biv_norm_integ_count(BIV_INTEG_ACB_CALLS));
+    biv_norm_integ_print_stats();
+
+    // value and partials; mpmath gives
+    // 0.1955243481 0.0707381024 0.2299994660 0.1112541041
+    Gradient3 g = biv_norm_cdf_grad(0.3, -0.7, 0.4);
+    g.value.println();
+    g.x.println();
+    g.y.println();
+    g.z.println();
+
+    // second partials; mpmath gives
+    // -0.0657230723 0.1164979846 0.1112541041 -0.0768183100 0.1086051968 -0.0220111578
+    Hessian3 h = biv_norm_cdf_hessian(0.3, -0.7, 0.4);
+    h.xx.println();
+    h.yy.println();
+    h.xy.println();
+    h.xz.println();
+    h.yz.println();
+    h.zz.println();
+
     // need more tests for partials
 
     flint_cleanup_master();
@@ -59,6 +59,33 @@ int main(int argc, char* argv[]) {
 
     // TODO: tests with b1 != b2
 
+    // fused partials should agree with the separate ones
+    Gradient3 g = Max2Sat::prob_from_rel_grad(-0.2, 0.35, 0.4, 0.8);
+    g.x.println();
+    Max2Sat::prob_from_rel_d_b1(-0.2, 0.35, 0.4, 0.8).println();
+    g.y.println();
+    Max2Sat::prob_from_rel_d_b2(-0.2, 0.35, 0.4, 0.8).println();
+    g.z.println();
+    Max2Sat::prob_from_rel_d_rho(-0.2, 0.35, 0.4, 0.8).println();
+
+    Gradient3 v = Max2Sat::value_from_rel_grad(-0.2, 0.35, 0.4);
+    v.x.println();
+    Max2Sat::value_from_rel_d_b1(-0.2, 0.35, 0.4).println();
+    v.y.println();
+    Max2Sat::value_from_rel_d_b2(-0.2, 0.35, 0.4).println();
+    v.z.println();
+    Max2Sat::value_from_rel_d_rho(-0.2, 0.35, 0.4).println();
+
+    // second partials of prob_from_rel; mpmath gives
+    // 0.0635363621 0.0693623424 -0.1659636803 -0.0638042567 0.0848029669 -0.0396316243
+    Hessian3 h = Max2Sat::prob_from_rel_hessian(-0.2, 0.35, 0.4, 0.8);
+    h.xx.println();
+    h.yy.println();
+    h.xy.println();
+    h.xz.println();
+    h.yz.println();
+    h.zz.println();
+
     flint_cleanup_master();
 
     return 0;
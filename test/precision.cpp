@@ -0,0 +1,68 @@
+/*
+  Copyright (c) 2022-23 Joshua Brakensiek, Neng Huang, Aaron Potechin and Uri Zwick
+
+  This code is licensed under the MIT License.
+*/
+
+#include <cstdio>
+#include <thread>
+#include "arb_wrapper.hpp"
+#include "args.hpp"
+#include "escalate.hpp"
+
+int main(int argc, char* argv[]) {
+    // command line
+    char prog[] = "test", a1[] = "--prec=53", a2[] = "--other=1", a3[] = "--prec=128";
+    char* args[] = {prog, a1, a2, a3};
+    flint_printf("%wd\n", arg_slong(2, args, "prec", 64));
+    flint_printf("%wd\n", arg_slong(4, args, "prec", 64));
+    flint_printf("%wd\n", arg_slong(1, args, "prec", 64));
+    flint_printf("%d\n", arg_str(4, args, "oth") == NULL);
+
+    parse_common_args(2, args);
+    flint_printf("%wd\n", Precision::get());
+    Precision::set_default(DEFAULT_PRECISION);
+    flint_printf("%wd\n", Precision::get());
+
+    // scoped precision
+    Arb x(1.0);
+    (x / 3).println();
+    {
+        Precision::Scope s(32);
+        flint_printf("%wd\n", Precision::get());
+        (x / 3).println();
+        {
+            Precision::Scope t(256);
+            flint_printf("%wd\n", Precision::get());
+        }
+        flint_printf("%wd\n", Precision::get());
+    }
+    flint_printf("%wd\n", Precision::get());
+
+    // other threads start at the default
+    Precision::set(128);
+    slong other = 0;
+    std::thread th([&other]() { other = Precision::get(); flint_cleanup(); });
+    th.join();
+    flint_printf("%wd %wd\n", Precision::get(), other);
+    Precision::set(DEFAULT_PRECISION);
+
+    // escalation: a test that needs 200 bits
+    slong tries = 0;
+    auto needs_200 = [&tries]() { tries++; return Precision::get() >= 200; };
+    int ok = escalate(needs_200);
+    flint_printf("%d %wd\n", ok, tries);
+    escalate_set_max_prec(256);
+    tries = 0;
+    ok = escalate(needs_200);
+    flint_printf("%d %wd %wd\n", ok, tries, Precision::get());
+    escalate_set_max_prec(150);
+    tries = 0;
+    ok = escalate(needs_200);
+    flint_printf("%d %wd\n", ok, tries);
+    escalate_print_stats();
+
+    flint_cleanup_master();
+
+    return 0;
+}
@@ -0,0 +1,144 @@
+/*
+  Copyright (c) 2022-23 Joshua Brakensiek, Neng Huang, Aaron Potechin and Uri Zwick
+
+  This code is licensed under the MIT License.
+*/
+
+#include <atomic>
+#include <cstdio>
+#include "verify.hpp"
+
+int main(int argc, char* argv[]) {
+    // boxes
+    Box b{Arb(0, 1), Arb(-1, 1), Arb(0.25, 0.75)};
+    flint_printf("%wd %wd\n", b.dim(), b.widest());
+    b.left_half(1).println();
+    b.right_half(0)[0].println();
+    b.vol().println();
+    // ties go to the first axis
+    flint_printf("%wd\n", Box{Arb(0, 1), Arb(0, 1)}.widest());
+
+    // cells: right, left, right of axis 1 is piece 5 of 8
+    Cell c = Cell(3).right_half(1).left_half(1).right_half(1).left_half(0);
+    flint_printf("%s %wd %wd %wu\n", c.str().c_str(), c.depth(), c.level(1), c.index(1));
+    // the same balls as halving the box itself
+    Box h = b.right_half(1).left_half(1).right_half(1).left_half(0);
+    Box cb = c.box(b);
+    for (slong i = 0; i < 3; i++) {
+        flint_printf("%d", arb_equal(cb[i].t, h[i].t));
+    }
+    flint_printf("\n");
+    // equal cells hash alike, whatever the order of the splits
+    Cell c2 = Cell(3).left_half(0).right_half(1).left_half(1).right_half(1);
+    flint_printf("%d %d %d\n", c == c2, c.hash() == c2.hash(), c == Cell(3));
+
+    // xy - xy < 1 on [-1, 1]^2 needs a few splits: at first it is [-2, 2]
+    auto zero = [](const Box &x) {
+        if (x[0] * x[1] - x[0] * x[1] < 1) {
+            return BOX_PROVEN;
+        }
+        return BOX_UNDECIDED;
+    };
+    slong splits = verify_splits();
+    BoxVerdict v = verify_box(Box{Arb(-1, 1), Arb(-1, 1)}, zero);
+    flint_printf("%d %d\n", v == BOX_PROVEN, verify_splits() > splits);
+
+    // x > 0.1 fails on [0, 1]: [0, 1/16] is the fifth box
+    slong boxes = 0;
+    auto above = [&boxes](const Box &x) {
+        boxes++;
+        if (x[0] > 0.1) {
+            return BOX_PROVEN;
+        }
+        if (x[0] < 0.1) {
+            return BOX_REFUTED;
+        }
+        return BOX_UNDECIDED;
+    };
+    v = verify_box(Box{Arb(0, 1)}, above);
+    flint_printf("%d %wd\n", v == BOX_REFUTED, boxes);
+
+    // a custom split policy: always the last axis, so three splits
+    // take y down to radius 1/4 while x stays whole
+    slong last_splits = 0;
+    auto last = [&last_splits](const Box &x) {
+        last_splits++;
+        return x.dim() - 1;
+    };
+    auto narrow = [](const Box &x) {
+        return (x[1].rad() <= 0.25) ? BOX_PROVEN : BOX_UNDECIDED;
+    };
+    v = verify_box(Box{Arb(-1, 1), Arb(-1, 1)}, narrow, last);
+    flint_printf("%d %wd\n", v == BOX_PROVEN, last_splits);
+
+    // the same on four threads, sharing every split
+    verify_set_threads(4);
+    verify_set_spawn_depth(64);
+    std::atomic<slong> shared_boxes(0);
+    v = verify_box(Box{Arb(-1, 1), Arb(-1, 1), Arb(-1, 1)}, [&shared_boxes](const Box &x) {
+        shared_boxes++;
+        if (x[0] * x[1] - x[0] * x[1] + x[1] * x[2] - x[1] * x[2] < 1) {
+            return BOX_PROVEN;
+        }
+        return BOX_UNDECIDED;
+    });
+    flint_printf("%d %d\n", v == BOX_PROVEN, shared_boxes.load() > 1);
+
+    // a refuted box stops all four threads, and only one reports it;
+    // which box that is depends on the timing, so the report is dropped
+    const char* path = "verify_test_report.txt";
+    verify_set_report(path);
+    std::atomic<slong> reports(0);
+    v = verify_box(Box{Arb(0, 1), Arb(0, 1)}, [](const Box &x) {
+        if (x[0] > 0.1) {
+            return BOX_PROVEN;
+        }
+        if (x[0] < 0.1) {
+            return BOX_REFUTED;
+        }
+        return BOX_UNDECIDED;
+    }, split_widest, [&reports](FILE* out, const Box &x) {
+        reports++;
+    });
+    flint_printf("%d %wd\n", v == BOX_REFUTED, reports.load());
+    verify_set_threads(1);
+    remove(path);
+
+    // the depth cap: x < 1/2 never decides [0, 1] around 1/2
+    verify_set_max_depth_cap(10);
+    auto half = [](const Box &x) {
+        return (x[0] < 0.5) ? BOX_PROVEN : BOX_UNDECIDED;
+    };
+    v = verify_box(Box{Arb(0, 1)}, half, split_widest, [](FILE* out, const Box &x) {
+        verify_fprint(out, "rad", x[0].rad());
+    });
+    flint_printf("%d\n", v == BOX_UNDECIDED);
+    verify_set_max_depth_cap(0);
+    verify_set_report(NULL);
+
+    FILE* in = fopen(path, "r");
+    char line[256];
+    while (in != NULL && fgets(line, sizeof(line), in) != NULL) {
+        flint_printf("%s", line);
+    }
+    if (in != NULL) {
+        fclose(in);
+    }
+    remove(path);
+
+    // the box cap: every split of a box wider than 2^-20 leaves its right
+    // half waiting, so the fourth split leaves five boxes
+    verify_set_max_boxes_cap(4);
+    auto thin = [](const Box &x) {
+        return (x[0].rad() < 0.000001) ? BOX_PROVEN : BOX_UNDECIDED;
+    };
+    v = verify_box(Box{Arb(0, 1)}, thin);
+    flint_printf("%d\n", v == BOX_UNDECIDED);
+    verify_set_max_boxes_cap(0);
+
+    verify_print_stats();
+
+    flint_cleanup_master();
+
+    return 0;
+}